@@ -0,0 +1,251 @@
+/******************************************************
+ * File:           bench.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Fixed-seed benchmark scenarios with per-phase timings
+ * Compile: gcc -O3 -march=native -o boid-bench bench.c simulation.c boid.c utils.c environment.c bitfire.c spatial_hash.c kernels.c rng.c threadpool.c section_pyramid.c chunks.c checkpoint.c recorder.c profile.c -lm -lpthread -lz
+ *          Add -DBENCH_RENDER display.c and the SDL flags to also time rendering
+ * Usage:   ./boid-bench [seed] [maxBoids] > results.jsonl
+ ******************************************************/
+
+#include "simulation.h"
+#include "kernels.h"
+#include "recorder.h"
+#include "utils.h"
+#include "constants.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef BENCH_RENDER
+#include "display.h"
+static SDL_Window* window = NULL;
+static SDL_Renderer* renderer = NULL;
+#endif
+
+typedef enum {
+    IGNITE_CENTER,    // One burning cell in the middle of the map
+    IGNITE_FRONT,     // Every tenth row and column set alight at once
+    IGNITE_SUSTAINED  // Every tenth cell of every tenth row, relit whenever it stops burning
+} IgnitionPattern;
+
+typedef struct {
+    const char* name;
+    FireEngine engine;
+    IgnitionPattern ignition;
+    unsigned int boids;   // 0 lets the swarm grow and shrink with the fire as in the viewer
+    unsigned int frames;
+    unsigned int threads; // 0 keeps NUM_THREADS
+    unsigned int cols;    // World size in cells, 0 keeps the screen-sized grid
+    unsigned int rows;
+    const char* recordPath; // Hands every frame to a recorder writing this file, removed afterwards, or NULL
+} Scenario;
+
+static const char* engineNames[] = {"dense", "sparse", "bitsliced"};
+
+static void Ignite(Simulation* sim, IgnitionPattern ignition)
+{
+    Grid* grid = &sim->grid;
+
+    if (ignition == IGNITE_CENTER)
+    {
+        IgniteCell(grid, grid->rows / 2, grid->cols / 2);
+        return;
+    }
+
+    if (ignition == IGNITE_SUSTAINED)
+    {
+        for (unsigned int rowIndex = 0; rowIndex < grid->rows; rowIndex += 10)
+        {
+            for (unsigned int colIndex = 0; colIndex < grid->cols; colIndex += 10)
+            {
+                if (GetCellState(grid, rowIndex, colIndex) != 1)
+                {
+                    IgniteCell(grid, rowIndex, colIndex);
+                }
+            }
+        }
+        return;
+    }
+
+    for (unsigned int rowIndex = 0; rowIndex < grid->rows; rowIndex++)
+    {
+        for (unsigned int colIndex = 0; colIndex < grid->cols; colIndex++)
+        {
+            if (rowIndex % 10 == 0 || colIndex % 10 == 0)
+            {
+                IgniteCell(grid, rowIndex, colIndex);
+            }
+        }
+    }
+}
+
+static void RunScenario(const Scenario* scenario, uint64_t seed)
+{
+    Simulation sim;
+    unsigned int cols = scenario->cols ? scenario->cols : GRID_WIDTH;
+    unsigned int rows = scenario->rows ? scenario->rows : GRID_HEIGHT;
+    unsigned int threads = scenario->threads > 0 ? scenario->threads : NUM_THREADS;
+    InitializeSimulationThreads(&sim, seed, scenario->engine, cols, rows, threads);
+
+    // Pin the swarm size so boid scaling is measured at exactly the requested count
+    if (scenario->boids > 0)
+    {
+        sim.minBoids = scenario->boids;
+        sim.maxBoids = scenario->boids;
+        FreeSwarm(&sim.swarm);
+        InitializeSwarm(&sim.swarm, scenario->boids, sim.worldWidth, sim.worldHeight);
+    }
+    Ignite(&sim, scenario->ignition);
+    sim.timePhases = true;
+    uint64_t startScanned = sim.grid.cellsScanned;
+
+    Recorder recorder;
+    if (scenario->recordPath && !OpenRecorder(&recorder, &sim, scenario->recordPath))
+    {
+        exit(1);
+    }
+
+    double boidUpdates = 0;
+    double burningCells = 0;
+    double renderSeconds = 0;
+#ifdef BENCH_RENDER
+    // Worlds other than the screen-sized grid are not rendered, they would not fit in a texture
+    bool render = (cols == GRID_WIDTH && rows == GRID_HEIGHT);
+    SDL_Texture* gridTexture = render ? CreateGridTexture(renderer, &sim.grid) : NULL;
+    SDL_Texture* homeSprite = CreateHomeTargetSprite(renderer);
+    BoidMesh boidMesh = {0};
+#endif
+    double startTime = GetTimeSeconds();
+    for (unsigned int frame = 0; frame < scenario->frames; frame++)
+    {
+        StepSimulation(&sim, 1);
+        if (scenario->ignition == IGNITE_SUSTAINED)
+        {
+            Ignite(&sim, IGNITE_SUSTAINED);  // Keeps the fire phases busy however fast the swarm puts it out
+        }
+        if (scenario->recordPath)
+        {
+            RecordFrame(&recorder, &sim);
+        }
+        boidUpdates += sim.swarm.count;
+        burningCells += sim.totalBurning;
+
+#ifdef BENCH_RENDER
+        if (render)
+        {
+            double renderStart = GetTimeSeconds();
+            RenderGrid(renderer, gridTexture, &sim.grid);
+            RenderHomeTargets(renderer, homeSprite, sim.homeTargets, NUM_HOME_TARGETS);
+            RenderBoids(renderer, &boidMesh, &sim.swarm, &sim.pool);
+            PresentFrame(renderer);
+            renderSeconds += GetTimeSeconds() - renderStart;
+        }
+#endif
+    }
+    double elapsed = GetTimeSeconds() - startTime - renderSeconds;
+    if (scenario->recordPath)
+    {
+        CloseRecorder(&recorder);
+        remove(scenario->recordPath);
+    }
+    // Cells the engine actually looked at, the sparse engine skips most of a quiet world
+    double cellUpdates = (double)(sim.grid.cellsScanned - startScanned);
+
+    printf("{\"scenario\":\"%s\",\"engine\":\"%s\",\"world\":\"%ux%u\",\"threads\":%u,\"seed\":%llu,\"frames\":%u,\"boids_mean\":%.1f,\"burning_mean\":%.1f,",
+           scenario->name, engineNames[scenario->engine], cols, rows, sim.pool.threadCount, (unsigned long long)seed, scenario->frames,
+           boidUpdates / scenario->frames, burningCells / scenario->frames);
+    printf("\"ms_per_frame\":%.4f,\"phase_ms_per_frame\":{", elapsed * 1e3 / scenario->frames);
+    for (unsigned int phase = 0; phase < SIM_PHASE_COUNT; phase++)
+    {
+        printf("\"%s\":%.4f,", GetPhaseName(phase), sim.phaseSeconds[phase] * 1e3 / scenario->frames);
+    }
+#ifdef BENCH_RENDER
+    printf("\"render\":%.4f},", renderSeconds * 1e3 / scenario->frames);
+#else
+    printf("\"render\":null},");
+#endif
+    printf("\"boid_updates_per_s\":%.0f,\"cell_updates_per_s\":%.0f,\"live_chunks\":%u,\"packed_chunks\":%u}\n",
+           boidUpdates / elapsed, cellUpdates / sim.phaseSeconds[SIM_PHASE_GRID], sim.grid.liveCount, sim.grid.packedCount);
+    fflush(stdout);
+
+#ifdef BENCH_RENDER
+    FreeBoidMesh(&boidMesh);
+    SDL_DestroyTexture(homeSprite);
+    if (gridTexture)
+    {
+        SDL_DestroyTexture(gridTexture);
+    }
+#endif
+    FreeSimulation(&sim);
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t seed = (argc > 1) ? strtoull(argv[1], NULL, 0) : 1;
+    unsigned int maxBoids = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : 1000000;
+
+#ifdef BENCH_RENDER
+    InitDisplay(&window, &renderer);
+#endif
+
+#ifdef __VERSION__
+    const char* compiler = __VERSION__;
+#else
+    const char* compiler = "unknown";
+#endif
+    printf("{\"bench\":\"boid-firefight\",\"kernels\":\"%s\",\"compiler\":\"%s\",\"grid\":\"%ux%u\",\"seed\":%llu}\n",
+           GetKernelName(), compiler, GRID_WIDTH, GRID_HEIGHT, (unsigned long long)seed);
+
+    // Fire scenarios on every engine, the swarm follows the fire as in the viewer
+    for (unsigned int engine = 0; engine < 3; engine++)
+    {
+        Scenario sparseFire = {"sparse_fire", (FireEngine)engine, IGNITE_CENTER, 0, 2000, 0, 0, 0, NULL};
+        Scenario largeFront = {"large_front", (FireEngine)engine, IGNITE_FRONT, 0, 500, 0, 0, 0, NULL};
+        Scenario maxSwarm = {"max_boids", (FireEngine)engine, IGNITE_FRONT, MAX_BOID_NUM, 500, 0, 0, 0, NULL};
+        RunScenario(&sparseFire, seed);
+        RunScenario(&largeFront, seed);
+        RunScenario(&maxSwarm, seed);
+    }
+
+    // One fire in a 100,000 by 100,000 cell world, only the chunks it reaches get storage
+    Scenario largeWorld = {"large_world", FIRE_ENGINE_SPARSE, IGNITE_CENTER, 0, 2000, 0, 100000, 100000, NULL};
+    RunScenario(&largeWorld, seed);
+
+    // Boid scaling curve at a fixed swarm size, frames shrink so each point takes similar time
+    for (unsigned int boids = 100; boids <= maxBoids; boids *= 10)
+    {
+        unsigned int frames = 200000 / boids;
+        if (frames < 5) frames = 5;
+        if (frames > 2000) frames = 2000;
+
+        char name[32];
+        snprintf(name, sizeof(name), "boids_%u", boids);
+        Scenario scaling = {name, FIRE_ENGINE, IGNITE_SUSTAINED, boids, frames, 0, 0, 0, NULL};
+        RunScenario(&scaling, seed);
+    }
+
+    // Thread scaling curve at 100,000 boids, doubling up to every online core
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    for (unsigned int threads = 1; threads <= (unsigned int)(cores > 0 ? cores : 1); threads *= 2)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "threads_%u", threads);
+        Scenario scaling = {name, FIRE_ENGINE, IGNITE_SUSTAINED, 100000, 10, threads, 0, 0, NULL};
+        RunScenario(&scaling, seed);
+    }
+
+    // Recording cost at 100,000 boids, compare with threads_1. The writer needs a core of its own, on a
+    // single core its compression shows up in every phase.
+    Scenario recording = {"record_100000", FIRE_ENGINE, IGNITE_SUSTAINED, 100000, 10, 1, 0, 0, "boid-bench.rec"};
+    RunScenario(&recording, seed);
+
+#ifdef BENCH_RENDER
+    CleanupDisplay(window, renderer);
+#endif
+    return 0;
+}
@@ -0,0 +1,200 @@
+/******************************************************
+ * File:           bitfire.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Bit-sliced wildfire engine, one bit per cell
+ ******************************************************/
+
+#include "environment.h"
+#include "utils.h"
+#include "constants.h"
+#include "profile.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SPREAD_PROBABILITY_BITS 16  // Precision of the random spread masks
+
+static uint64_t* AllocatePlane(unsigned int words) {
+    uint64_t* plane = (uint64_t*)calloc(words, sizeof(uint64_t));
+    if (!plane) {
+        fprintf(stderr, "Memory allocation failed for fire bitplanes\n");
+        exit(1);
+    }
+    return plane;
+}
+
+void InitializeFireBitplanes(Grid* grid) {
+    FireBitplanes* planes = &grid->planes;
+    planes->wordsPerRow = (grid->cols + 63) / 64;
+    unsigned int words = grid->rows * planes->wordsPerRow;
+
+    planes->burning = AllocatePlane(words);
+    planes->unburnt = AllocatePlane(words);
+    planes->ignited = AllocatePlane(words);
+    for (unsigned int slot = 0; slot < BURNOUT_WHEEL_SIZE; ++slot) {
+        planes->burnout[slot] = AllocatePlane(words);
+    }
+
+    // The grid starts out unburnt. Bits past the last column stay clear in unburnt, so spread never lands there.
+    uint64_t lastWord = (grid->cols % 64) ? (1ull << (grid->cols % 64)) - 1 : ~0ull;
+    for (unsigned int rowIndex = 0; rowIndex < grid->rows; ++rowIndex) {
+        uint64_t* row = &planes->unburnt[rowIndex * planes->wordsPerRow];
+        memset(row, 0xFF, (planes->wordsPerRow - 1) * sizeof(uint64_t));
+        row[planes->wordsPerRow - 1] = lastWord;
+    }
+}
+
+void FreeFireBitplanes(Grid* grid) {
+    FireBitplanes* planes = &grid->planes;
+    free(planes->burning);
+    free(planes->unburnt);
+    free(planes->ignited);
+    for (unsigned int slot = 0; slot < BURNOUT_WHEEL_SIZE; ++slot) {
+        free(planes->burnout[slot]);
+    }
+    *planes = (FireBitplanes){0};
+}
+
+void SetBitplaneBurning(Grid* grid, unsigned int row, unsigned int col, unsigned int burnoutTick) {
+    FireBitplanes* planes = &grid->planes;
+    unsigned int word = row * planes->wordsPerRow + col / 64;
+    uint64_t bit = 1ull << (col % 64);
+
+    planes->burning[word] |= bit;
+    planes->unburnt[word] &= ~bit;
+    planes->burnout[burnoutTick % BURNOUT_WHEEL_SIZE][word] |= bit;
+}
+
+// Takes the cell out of both the burning and unburnt planes, it is relit or put out by the caller
+void ClearBitplaneBurning(Grid* grid, unsigned int row, unsigned int col, unsigned int burnoutTick) {
+    FireBitplanes* planes = &grid->planes;
+    unsigned int word = row * planes->wordsPerRow + col / 64;
+    uint64_t bit = 1ull << (col % 64);
+
+    // Atomic, boids on other threads may be putting out cells in the same words
+    __atomic_fetch_and(&planes->burning[word], ~bit, __ATOMIC_RELAXED);
+    __atomic_fetch_and(&planes->unburnt[word], ~bit, __ATOMIC_RELAXED);
+    __atomic_fetch_and(&planes->burnout[burnoutTick % BURNOUT_WHEEL_SIZE][word], ~bit, __ATOMIC_RELAXED);
+}
+
+// 64 independent bits, each set with probability threshold / 2^SPREAD_PROBABILITY_BITS. Walks the binary
+// expansion of the probability from its lowest bit: OR with a fresh word adds 1/2, AND halves.
+// Words are numbered from counter, so a mask only depends on where it is used, not on who computes it.
+static uint64_t RandomMask(uint64_t key, uint64_t counter, unsigned int threshold) {
+    uint64_t mask = 0;
+    for (unsigned int bit = 0; bit < SPREAD_PROBABILITY_BITS; ++bit) {
+        uint64_t random = RngAt(key, counter + bit);
+        mask = (threshold & (1u << bit)) ? (mask | random) : (mask & random);
+    }
+    return mask;
+}
+
+typedef struct {
+    Grid* grid;
+    unsigned int threshold;
+    uint64_t spreadKey;
+} BitslicedFireTask;
+
+// Spread for one band of FIRE_TILE_ROWS rows. Reads the start-of-step planes, including one row
+// of halo on each side, and only writes its own rows of the ignited plane.
+static void StepBitslicedTile(void* context, unsigned int begin, unsigned int end, unsigned int thread) {
+    BitslicedFireTask* task = (BitslicedFireTask*)context;
+    (void)thread;
+    Grid* grid = task->grid;
+    FireBitplanes* planes = &grid->planes;
+    unsigned int wordsPerRow = planes->wordsPerRow;
+    uint64_t stepCounter = (uint64_t)grid->tick * grid->rows * wordsPerRow;
+
+    for (unsigned int tile = begin; tile < end; ++tile) {
+        unsigned int startRow = tile * FIRE_TILE_ROWS;
+        unsigned int endRow = (startRow + FIRE_TILE_ROWS < grid->rows) ? startRow + FIRE_TILE_ROWS : grid->rows;
+
+        // Spread: every unburnt cell gets one independent trial per burning 4-neighbor
+        for (unsigned int rowIndex = startRow; rowIndex < endRow; ++rowIndex) {
+            const uint64_t* row = &planes->burning[rowIndex * wordsPerRow];
+            const uint64_t* above = (rowIndex > 0) ? row - wordsPerRow : NULL;
+            const uint64_t* below = (rowIndex + 1 < grid->rows) ? row + wordsPerRow : NULL;
+            uint64_t* ignited = &planes->ignited[rowIndex * wordsPerRow];
+
+            for (unsigned int word = 0; word < wordsPerRow; ++word) {
+                uint64_t fromAbove = above ? above[word] : 0;
+                uint64_t fromBelow = below ? below[word] : 0;
+                uint64_t fromLeft = (row[word] << 1) | (word > 0 ? row[word - 1] >> 63 : 0);
+                uint64_t fromRight = (row[word] >> 1) | (word + 1 < wordsPerRow ? row[word + 1] << 63 : 0);
+                uint64_t candidates = planes->unburnt[rowIndex * wordsPerRow + word];
+
+                // Only draw random masks where something can actually catch
+                if ((candidates & (fromAbove | fromBelow | fromLeft | fromRight)) == 0) {
+                    ignited[word] = 0;
+                    continue;
+                }
+
+                uint64_t counter = (stepCounter + rowIndex * wordsPerRow + word) * 4 * SPREAD_PROBABILITY_BITS;
+                uint64_t caught = 0;
+                if (candidates & fromAbove) caught |= fromAbove & RandomMask(task->spreadKey, counter, task->threshold);
+                if (candidates & fromBelow) caught |= fromBelow & RandomMask(task->spreadKey, counter + SPREAD_PROBABILITY_BITS, task->threshold);
+                if (candidates & fromLeft) caught |= fromLeft & RandomMask(task->spreadKey, counter + 2 * SPREAD_PROBABILITY_BITS, task->threshold);
+                if (candidates & fromRight) caught |= fromRight & RandomMask(task->spreadKey, counter + 3 * SPREAD_PROBABILITY_BITS, task->threshold);
+                ignited[word] = candidates & caught;
+            }
+        }
+    }
+}
+
+void StepBitslicedFire(Grid* grid, float spreadProbability) {
+    FireBitplanes* planes = &grid->planes;
+    unsigned int wordsPerRow = planes->wordsPerRow;
+    unsigned int threshold = (unsigned int)(spreadProbability * (1u << SPREAD_PROBABILITY_BITS) + 0.5f);
+
+    grid->tick++;
+
+    unsigned int tileCount = (grid->rows + FIRE_TILE_ROWS - 1) / FIRE_TILE_ROWS;
+    BitslicedFireTask task = {grid, threshold, RngStreamKey(GetRandomSeed(), RNG_STREAM_SPREAD, 0)};
+    RunParallel(grid->pool, tileCount, 1, StepBitslicedTile, &task);
+    uint64_t scanned = (uint64_t)grid->rows * wordsPerRow * 64;
+    grid->cellsScanned += scanned;
+    PROFILE_COUNT(PROFILE_CELLS_SCANNED, scanned);
+
+    // Burn out the cells scheduled for this tick
+    uint64_t* burnout = planes->burnout[grid->tick % BURNOUT_WHEEL_SIZE];
+    for (unsigned int word = 0; word < grid->rows * wordsPerRow; ++word) {
+        uint64_t burnt = burnout[word] & planes->burning[word];
+        burnout[word] = 0;
+        if (burnt == 0) {
+            continue;
+        }
+
+        planes->burning[word] &= ~burnt;
+        unsigned int rowIndex = word / wordsPerRow;
+        unsigned int colBase = (word % wordsPerRow) * 64;
+        while (burnt) {
+            unsigned int colIndex = colBase + __builtin_ctzll(burnt);
+            burnt &= burnt - 1;
+            SetCellState(grid, rowIndex, colIndex, 2); // Change to burnt
+        }
+    }
+
+    // Apply the ignitions, the byte grid and burnout planes are only touched per changed cell
+    for (unsigned int word = 0; word < grid->rows * wordsPerRow; ++word) {
+        uint64_t ignited = planes->ignited[word];
+        unsigned int rowIndex = word / wordsPerRow;
+        unsigned int colBase = (word % wordsPerRow) * 64;
+        while (ignited) {
+            unsigned int colIndex = colBase + __builtin_ctzll(ignited);
+            ignited &= ignited - 1;
+            IgniteCell(grid, rowIndex, colIndex);
+        }
+    }
+
+    // Random ignition
+    if (GetRandomFloat(RNG_STREAM_IGNITION, 0.0f, 1.0f) < grid->ignitionProbability) {
+        unsigned int randomRow = (unsigned int)GetRandomFloat(RNG_STREAM_IGNITION, 5, grid->rows - 5);
+        unsigned int randomCol = (unsigned int)GetRandomFloat(RNG_STREAM_IGNITION, 5, grid->cols - 5);
+        if (GetCellState(grid, randomRow, randomCol) == 0) {
+            IgniteCell(grid, randomRow, randomCol);
+        }
+    }
+}
@@ -3,187 +3,224 @@
  * Project:        Boid Swarm Firefight
  * Author:         Peter Ryseck
  * Date Created:   February 8, 2025
- * Last Updated:   February 8, 2025
+ * Last Updated:   October 16, 2026
  *
  * Description:    Boid logic
- * Compile: gcc -O3 -o boid boid.c utils.c display.c environment.c -I/opt/homebrew/include/SDL2 -L/opt/homebrew/lib -L/opt/homebrew/opt/openblas/lib -I/opt/homebrew/opt/openblas/include -lopenblas -lSDL2
  ******************************************************/
 
 #include "boid.h"
 #include "utils.h"
 #include "stdlib.h"
-#include "display.h"
 #include "environment.h"
+#include "spatial_hash.h"
+#include "kernels.h"
+#include "simulation.h"
 #include "constants.h"
+#include "profile.h"
+#include <float.h>
 #include <math.h>
 #include <stdbool.h>
-#include "constants.h"
+#include <stdio.h>
+#include <string.h>
 
-static Boid* InitializeBoids(const unsigned int numBoids) 
+// Only place the swarm touches the allocator, reserve up front to keep spawning allocation free
+void ReserveSwarm(Swarm* swarm, unsigned int capacity)
 {
-    Boid* boids = (Boid*)malloc(numBoids * sizeof(Boid));
-    if (boids == NULL)
+    if (capacity <= swarm->capacity)
     {
-        return NULL;
+        return;
     }
 
-    for (unsigned int index = 0; index < numBoids; index++)
+    if (capacity > MAX_SWARM_CAPACITY)
     {
-        boids[index].posx = GetRandomFloat(0, SCREEN_WIDTH);
-        boids[index].posy = GetRandomFloat(0, SCREEN_HEIGHT);
-        boids[index].velx = GetRandomFloat(-MAX_SPEED, MAX_SPEED);
-        boids[index].vely = GetRandomFloat(-MAX_SPEED, MAX_SPEED);
-        boids[index].energy = MAX_ENERGY;
-        boids[index].headingHomeToBeRemoved = false;
-        boids[index].headingHome = false;
+        fprintf(stderr, "Swarm of %u boids is over MAX_SWARM_CAPACITY\n", capacity);
+        exit(1);
     }
 
-    return boids;
-}
+    // Round up so the kernels can always run whole batches
+    capacity = (capacity + BOID_BATCH - 1) / BOID_BATCH * BOID_BATCH;
 
-static Boid* AddBoid(Boid* boids, unsigned int* numBoids, unsigned int locationX, unsigned int locationY) 
-{
-    // Increase the size of the boids array by 1
-    Boid* newBoids = (Boid*)realloc(boids, (*numBoids + 1) * sizeof(Boid));
-    if (newBoids == NULL)
+    float** arrays[5] = {&swarm->posx, &swarm->posy, &swarm->velx, &swarm->vely, &swarm->energy};
+    for (unsigned int array = 0; array < 5; array++)
     {
-        return NULL; // Return NULL if memory allocation fails
+        float* newArray = (float*)AllocateAligned(capacity, sizeof(float));
+        if (*arrays[array] != NULL)
+        {
+            memcpy(newArray, *arrays[array], swarm->count * sizeof(float));
+            free(*arrays[array]);
+        }
+        *arrays[array] = newArray;
     }
 
-    // Add the new boid at the end of the array
-    newBoids[*numBoids].posx = locationX;
-    newBoids[*numBoids].posy = locationY;
-    newBoids[*numBoids].velx = GetRandomFloat(-MAX_SPEED, MAX_SPEED);
-    newBoids[*numBoids].vely = GetRandomFloat(-MAX_SPEED, MAX_SPEED);
-    newBoids[*numBoids].energy = MAX_ENERGY;
-    newBoids[*numBoids].headingHome = false;
+    unsigned char* newFlags = (unsigned char*)AllocateAligned(capacity, sizeof(unsigned char));
+    if (swarm->flags != NULL)
+    {
+        memcpy(newFlags, swarm->flags, swarm->count * sizeof(unsigned char));
+        free(swarm->flags);
+    }
+    swarm->flags = newFlags;
+    swarm->capacity = capacity;
+}
 
-    // Increment the boid count
-    (*numBoids)++;
+// Boids start anywhere in a width by height pixel world
+void InitializeSwarm(Swarm* swarm, const unsigned int numBoids, float width, float height)
+{
+    *swarm = (Swarm){0};
+    ReserveSwarm(swarm, numBoids);
 
-    return newBoids; // Return the updated array
+    RngStream* stream = GetRngStream(RNG_STREAM_INIT);
+    RngFillUniform(stream, swarm->posx, numBoids, 0, width);
+    RngFillUniform(stream, swarm->posy, numBoids, 0, height);
+    RngFillUniform(stream, swarm->velx, numBoids, -MAX_SPEED, MAX_SPEED);
+    RngFillUniform(stream, swarm->vely, numBoids, -MAX_SPEED, MAX_SPEED);
+
+    for (unsigned int index = 0; index < numBoids; index++)
+    {
+        swarm->energy[index] = MAX_ENERGY;
+        swarm->flags[index] = 0;
+    }
+    swarm->count = numBoids;
 }
 
-static Boid* RemoveBoid(Boid* boids, unsigned int* numBoids, unsigned int indexToRemove)
+void FreeSwarm(Swarm* swarm)
 {
-    if (boids[indexToRemove].headingHomeToBeRemoved == true && boids[indexToRemove].headingHome == false)
-    {
-        // Check if the index is valid
-        if (indexToRemove >= *numBoids)
-        {
-            return boids; // Return the original array if the index is invalid
-        }
+    free(swarm->posx);
+    free(swarm->posy);
+    free(swarm->velx);
+    free(swarm->vely);
+    free(swarm->energy);
+    free(swarm->flags);
+    *swarm = (Swarm){0};
+}
 
-        // Shift all elements after the index to the left
-        for (unsigned int index = indexToRemove; index < *numBoids - 1; index++)
-        {
-            boids[index] = boids[index + 1];
-        }
+void AddBoid(Swarm* swarm, unsigned int locationX, unsigned int locationY)
+{
+    // Grow geometrically, so most additions do not touch the allocator
+    if (swarm->count == swarm->capacity)
+    {
+        ReserveSwarm(swarm, swarm->capacity ? swarm->capacity * 2 : BOID_BATCH);
+    }
 
-        // Reduce the size of the array by 1
-        Boid* newBoids = (Boid*)realloc(boids, (*numBoids - 1) * sizeof(Boid));
-        if (newBoids == NULL && *numBoids - 1 > 0)
-        {
-            // If realloc fails and the array is not empty, keep the original array
-            return boids;
-        }
+    // Add the new boid at the end of the arrays
+    unsigned int index = swarm->count;
+    swarm->posx[index] = locationX;
+    swarm->posy[index] = locationY;
+    swarm->velx[index] = GetRandomFloat(RNG_STREAM_SPAWN, -MAX_SPEED, MAX_SPEED);
+    swarm->vely[index] = GetRandomFloat(RNG_STREAM_SPAWN, -MAX_SPEED, MAX_SPEED);
+    swarm->energy[index] = MAX_ENERGY;
+    swarm->flags[index] = 0;
 
-        // Decrement the boid count
-        (*numBoids)--;
+    // Increment the boid count
+    swarm->count++;
+}
 
-        return newBoids; // Return the updated array
-    }
-    else
+// Swap-and-pop: the last boid moves into the freed slot, so removal is O(1) but does not keep order
+void RemoveBoid(Swarm* swarm, unsigned int indexToRemove)
+{
+    // Check if the index is valid
+    if (indexToRemove >= swarm->count)
     {
-        return boids;
+        return;
     }
+
+    unsigned int last = swarm->count - 1;
+    swarm->posx[indexToRemove] = swarm->posx[last];
+    swarm->posy[indexToRemove] = swarm->posy[last];
+    swarm->velx[indexToRemove] = swarm->velx[last];
+    swarm->vely[indexToRemove] = swarm->vely[last];
+    swarm->energy[indexToRemove] = swarm->energy[last];
+    swarm->flags[indexToRemove] = swarm->flags[last];
+
+    // Decrement the boid count
+    swarm->count--;
 }
 
-static void ApplySteering(Boid *boid, SteerForce *vectorSum, unsigned int total, float steerForce, bool normalizeFlag, bool subtractPosFlag)
+// Despawn pass, run once per frame after the update: drops boids marked for removal that made it home
+void RemoveFlaggedBoids(Swarm* swarm)
 {
-    if (total > 0)
+    unsigned int index = 0;
+    while (index < swarm->count)
     {
-        SteerForce avgSteer = {0, 0};
-        avgSteer.x = vectorSum->x / total;
-        avgSteer.y = vectorSum->y / total;
-
-        if (subtractPosFlag)
+        if ((swarm->flags[index] & BOID_TO_BE_REMOVED) && !(swarm->flags[index] & BOID_HEADING_HOME))
         {
-            avgSteer.x -= boid->posx;
-            avgSteer.y -= boid->posy;
+            RemoveBoid(swarm, index);  // Recheck this slot, it now holds the former last boid
         }
-
-        if (normalizeFlag)
+        else
         {
-            LimitVector(&avgSteer.x, &avgSteer.y, MIN_SPEED, MAX_SPEED);
+            index++;
         }
+    }
+}
+
+// Returns the number of candidate neighbors compared, for profiling
+static unsigned int ComputeBehavior(const Swarm *swarm, const SpatialHash *hash, FlockSums *sums, unsigned int index)
+{
+    sums->alignment.sumx[index] = sums->alignment.sumy[index] = sums->alignment.total[index] = 0;
+    sums->cohesion.sumx[index] = sums->cohesion.sumy[index] = sums->cohesion.total[index] = 0;
+    sums->separation.sumx[index] = sums->separation.sumy[index] = sums->separation.total[index] = 0;
 
-        avgSteer.x -= boid->velx;
-        avgSteer.y -= boid->vely;
+    // Only the 3x3 buckets around the boid can hold neighbors
+    unsigned int cellX, cellY;
+    GetSpatialHashCell(hash, swarm->posx[index], swarm->posy[index], &cellX, &cellY);
 
-        LimitVector(&avgSteer.x, &avgSteer.y, 0, steerForce);
+    unsigned int minCellX = (cellX > 0) ? cellX - 1 : 0;
+    unsigned int maxCellX = (cellX + 1 < hash->cols) ? cellX + 1 : cellX;
+    unsigned int minCellY = (cellY > 0) ? cellY - 1 : 0;
+    unsigned int maxCellY = (cellY + 1 < hash->rows) ? cellY + 1 : cellY;
+    unsigned int pairs = 0;
+
+    for (unsigned int neighborCellY = minCellY; neighborCellY <= maxCellY; neighborCellY++)
+    {
+        // Buckets in a row are contiguous in the bucket-ordered snapshot
+        unsigned int start = hash->cellStart[neighborCellY * hash->cols + minCellX];
+        unsigned int end = hash->cellStart[neighborCellY * hash->cols + maxCellX + 1];
 
-        boid->velx += avgSteer.x;
-        boid->vely += avgSteer.y;
-        LimitVector(&boid->velx, &boid->vely, MIN_SPEED, MAX_SPEED);
+        AccumulateNeighbors(hash->posx, hash->posy, hash->velx, hash->vely, start, end, hash->boidSlot[index],
+                            swarm->posx[index], swarm->posy[index], sums, index);
+        pairs += end - start;
     }
+    return pairs;
 }
 
-static void ComputeBehavior(Boid *boid, Boid *boids, const unsigned int numBoids)
+typedef struct
 {
-    SteerForce alignSum = {0, 0};
-    SteerForce cohesionSum = {0, 0};
-    SteerForce separationSum = {0, 0};
-    SteerForce posDiff = {0, 0};
-    SteerForce diff = {0, 0};
-    unsigned int alignTotal = 0, cohesionTotal = 0, separationTotal = 0;
+    const Swarm *swarm;
+    const SpatialHash *hash;
+    FlockSums *sums;
+} FlockTask;
 
-    for (unsigned int index = 0; index < numBoids; index++)
+static void ComputeBehaviorRange(void *context, unsigned int begin, unsigned int end, unsigned int thread)
+{
+    FlockTask *task = (FlockTask *)context;
+    (void)thread;
+    uint64_t pairs = 0;
+    for (unsigned int index = begin; index < end; index++)
     {
-        if (boid == &boids[index])
-        {
-            continue;
-        }
-
-        posDiff.x = boids[index].posx - boid->posx;
-        posDiff.y = boids[index].posy - boid->posy;
-
-        float dist = Distance(boid, &boids[index]);
-        
-        if (dist < ALIGNMENT_RADIUS)
-        {
-            alignSum.x += boids[index].velx;
-            alignSum.y += boids[index].vely;
-            alignTotal += 1;
-        }
+        pairs += ComputeBehavior(task->swarm, task->hash, task->sums, index);
+    }
+    PROFILE_COUNT(PROFILE_NEIGHBOR_PAIRS, pairs);
+}
 
-        if (dist < COHESION_RADIUS)
-        {
-            cohesionSum.x += boids[index].posx;
-            cohesionSum.y += boids[index].posy;
-            cohesionTotal += 1;
-        }
+// Flocking for the whole swarm: neighbors are read from the snapshot taken when the hash is built,
+// so every boid steers against the same frame-start state regardless of array order or thread
+void FlockSwarm(Swarm *swarm, SpatialHash *hash, FlockSums *sums, ThreadPool *pool)
+{
+    BuildSpatialHash(hash, swarm);
+    ReserveFlockSums(sums, swarm->capacity);
 
-        if (dist < SEPARATION_RADIUS && dist != 0)
-        {
-            diff.x = -posDiff.x / dist;
-            diff.y = -posDiff.y / dist;
-            separationSum.x += diff.x;
-            separationSum.y += diff.y;
-            separationTotal += 1;
-        }
-    }
+    FlockTask task = {swarm, hash, sums};
+    RunParallel(pool, swarm->count, BOID_TASK_GRAIN, ComputeBehaviorRange, &task);
 
-    ApplySteering(boid, &alignSum, alignTotal, MAX_ALIGNMENT_FORCE, true, false);
-    ApplySteering(boid, &cohesionSum, cohesionTotal, MAX_COHESION_FORCE, false, true);
-    ApplySteering(boid, &separationSum, separationTotal, MAX_SEPERATION_FORCE, true, false);
+    ApplySteeringSums(swarm, &sums->alignment, MAX_ALIGNMENT_FORCE, true, false);
+    ApplySteeringSums(swarm, &sums->cohesion, MAX_COHESION_FORCE, false, true);
+    ApplySteeringSums(swarm, &sums->separation, MAX_SEPERATION_FORCE, true, false);
 }
 
-static void TargetBehavior(Boid *boid, float targetX, float targetY, float maxForceTarget)
+static void TargetBehavior(Swarm *swarm, unsigned int index, float targetX, float targetY, float maxForceTarget)
 {
     // Calculate desired vector
-    float desiredX = targetX - boid->posx;
-    float desiredY = targetY - boid->posy;
+    float desiredX = targetX - swarm->posx[index];
+    float desiredY = targetY - swarm->posy[index];
 
     // Compute magnitude of desired vector
     float magDesired;
@@ -198,111 +235,62 @@ static void TargetBehavior(Boid *boid, float targetX, float targetY, float maxFo
     }
 
     // Calculate steering vector: desired - velocity
-    float steeringX = desiredX - boid->velx;
-    float steeringY = desiredY - boid->vely;
+    float steeringX = desiredX - swarm->velx[index];
+    float steeringY = desiredY - swarm->vely[index];
 
     // Limit steering force to maxForceTarget
     LimitVector(&steeringX, &steeringY, 0, maxForceTarget);
 
     // Update boid's velocity with the steering force
-    boid->velx += steeringX;
-    boid->vely += steeringY;
+    swarm->velx[index] += steeringX;
+    swarm->vely[index] += steeringY;
 }
 
-static void UpdateBoid(Boid *boid, Boid *boids, unsigned int numBoids, HomeTarget* homeTargets, Grid *grid,
-            const unsigned int numSectionsX, const unsigned int numSectionsY, float** sectionIntensity)
+// Target steering for one boid, run after FlockSwarm; position and energy are integrated afterwards.
+// Only writes the boid's own slots and claims on the grid, so boids can run on any thread in any order.
+// A boid in reach of a fire claims it and reports it in claimedCell (-1 if none); the caller puts out
+// the cell for the boid that ends up holding the claim.
+void UpdateBoid(Swarm *swarm, unsigned int index, const HomeTarget* homeTargets, Grid *grid,
+                const FireField *fireField, const SectionPyramid *sections, float maxForceTarget, int64_t* claimedCell)
 {
-    ComputeBehavior(boid, boids, numBoids);
+    float posx = swarm->posx[index];
+    float posy = swarm->posy[index];
+    unsigned char* flags = &swarm->flags[index];
+    *claimedCell = -1;
 
-    SteerForce targetForce = {0, 0};
-
-    float highestWeightedIntensity = -FLT_MAX;
+    // Section with the highest intensity weighted by inverse distance, found by walking down the pyramid
     int targetSectionX = -1, targetSectionY = -1;
+    float highestWeightedIntensity = FindTargetSection(sections, posx, posy, &targetSectionX, &targetSectionY);
 
-    // Loop through each section
-    for (unsigned int sectionX = 0; sectionX < numSectionsX; sectionX++)
-    {
-        for (unsigned int sectionY = 0; sectionY < numSectionsY; sectionY++)
-        {
-            // Calculate the center of the section
-            float sectionCenterX = (sectionX + 0.5f) * (grid->cols / numSectionsX) * CELL_SIZE;
-            float sectionCenterY = (sectionY + 0.5f) * (grid->rows / numSectionsY) * CELL_SIZE;
-
-            // Calculate the distance from the boid to the section center
-            float distance = EuclideanDistance(sectionCenterX, sectionCenterY, boid->posx, boid->posy);
-
-            // Limit distance so that boids don't go straight to center of section
-            if (distance < 50)
-            {
-                distance = 50; 
-            }
-
-            // Invert the distance to get a weighting factor (closer = higher weight)
-            float distanceWeight = (distance > 0.0f) ? (1.0f / distance) : FLT_MAX;
-
-            // Compute the weighted intensity
-            float weightedIntensity = sectionIntensity[sectionX][sectionY] * distanceWeight;
-
-            // Find the section with the highest weighted intensity
-            if (weightedIntensity > highestWeightedIntensity)
-            {
-                highestWeightedIntensity = weightedIntensity;
-                targetSectionX = sectionX;
-                targetSectionY = sectionY;
-            }
-        }
-    }
-
-    if (!boid->headingHome && !boid->headingHomeToBeRemoved && (boid->energy > MIN_ENERGY))
+    if (!(*flags & (BOID_HEADING_HOME | BOID_TO_BE_REMOVED)) && (swarm->energy[index] > MIN_ENERGY))
     {
         if (targetSectionX >= 0 && targetSectionY >= 0 && highestWeightedIntensity > 0)
         {
-            float targetX = (targetSectionX * (GRID_WIDTH / numSectionsX) + (GRID_WIDTH / numSectionsX) / 2) * CELL_SIZE;
-            float targetY = (targetSectionY * (GRID_HEIGHT / numSectionsY) + (GRID_HEIGHT / numSectionsY) / 2) * CELL_SIZE;
+            float targetX = (targetSectionX * sections->sectionCols + sections->sectionCols / 2) * CELL_SIZE;
+            float targetY = (targetSectionY * sections->sectionRows + sections->sectionRows / 2) * CELL_SIZE;
 
-            TargetBehavior(boid, targetX, targetY, MAX_FORCE_INTENSITY_DISTRIBUTION);
+            TargetBehavior(swarm, index, targetX, targetY, MAX_FORCE_INTENSITY_DISTRIBUTION);
         }
 
+        // Closest burning cell from the per-frame fire field
         float closestDistance = SEARCH_RADIUS;
         float closestFireX = -1, closestFireY = -1;
-
-        // find closest fire
-        for (int rowIndex = 0; rowIndex < GRID_HEIGHT; rowIndex++)
-        {
-            for (int colIndex = 0; colIndex < GRID_WIDTH; colIndex++)
-            {
-                Cell *cell = &grid->cells[rowIndex][colIndex];
-                if (cell->state == 1) // Burning state
-                {
-                    float cellCenterX = colIndex * CELL_SIZE + CELL_SIZE / 2.0f;
-                    float cellCenterY = rowIndex * CELL_SIZE + CELL_SIZE / 2.0f;
-
-                    float distance = EuclideanDistance(cellCenterX, cellCenterY, boid->posx, boid->posy);
-
-                    if (distance < closestDistance)
-                    {
-                        closestDistance = distance;
-                        closestFireX = cellCenterX;
-                        closestFireY = cellCenterY;
-                    }
-                }
-            }
-        }
+        FindClosestFire(fireField, grid, posx, posy, &closestFireX, &closestFireY, &closestDistance);
 
         // If a fire target is found, compute target force
         if (closestFireX >= 0 && closestFireY >= 0)
         {
-            TargetBehavior(boid, closestFireX, closestFireY, MAX_FORCE_TARGET);
+            TargetBehavior(swarm, index, closestFireX, closestFireY, maxForceTarget);
 
             // Extinguish fire if near the target
             if (closestDistance < TARGET_REACHED_RADIUS)
             {
                 int col = (int)(closestFireX / CELL_SIZE);
                 int row = (int)(closestFireY / CELL_SIZE);
-                if (row >= 0 && row < GRID_HEIGHT && col >= 0 && col < GRID_WIDTH && grid->cells[row][col].state == 1)
+                if (row >= 0 && row < (int)grid->rows && col >= 0 && col < (int)grid->cols && GetCellState(grid, row, col) == 1)
                 {
-                    grid->cells[row][col].state = 3; // Extinguished
-                    boid->headingHome = true;
+                    ClaimCell(grid, row, col, index);
+                    *claimedCell = (int64_t)row * grid->cols + col;
                 }
             }
         }
@@ -313,227 +301,24 @@ static void UpdateBoid(Boid *boid, Boid *boids, unsigned int numBoids, HomeTarge
         float closestDistance = FLT_MAX;
         float closestHomeX = 0, closestHomeY = 0;
 
-        for (int index = 0; index < NUM_HOME_TARGETS; index++)
+        for (int target = 0; target < NUM_HOME_TARGETS; target++)
         {
-            float distance = EuclideanDistance(homeTargets[index].x, homeTargets[index].y, boid->posx, boid->posy);
+            float distance = EuclideanDistance(homeTargets[target].x, homeTargets[target].y, posx, posy);
 
             if (distance < closestDistance)
             {
                 closestDistance = distance;
-                closestHomeX = homeTargets[index].x;
-                closestHomeY = homeTargets[index].y;
+                closestHomeX = homeTargets[target].x;
+                closestHomeY = homeTargets[target].y;
             }
         }
 
-        TargetBehavior(boid, closestHomeX, closestHomeY, MAX_FORCE_TARGET);
+        TargetBehavior(swarm, index, closestHomeX, closestHomeY, maxForceTarget);
 
         if (closestDistance < TARGET_REACHED_RADIUS)
         {
-            boid->headingHome = false;
-            boid->energy = MAX_ENERGY;
-        }
-    }
-
-    float mag;
-    Magnitude(boid->velx, boid->vely, &mag);
-    boid->energy = fmaxf(0.0f, (boid->energy - mag));
-    boid->posx += boid->velx ;
-    boid->posy += boid->vely ;
-}
-
-static void Edges(Boid *boid)
-{
-    SteerForce edgeSum = {0, 0};
-    if (boid->posx < WALL_MARGIN)
-    {
-        edgeSum.x = MAX_SPEED;
-    }
-    else if (boid->posx > SCREEN_WIDTH - WALL_MARGIN)
-    {
-        edgeSum.x = -MAX_SPEED;
-    }
-
-    if (boid->posy < WALL_MARGIN)
-    {
-        edgeSum.y = MAX_SPEED;
-    }
-    else if (boid->posy > SCREEN_HEIGHT - WALL_MARGIN)
-    {
-        edgeSum.y = -MAX_SPEED;
-    }
-
-    float mag;
-    Magnitude(edgeSum.x, edgeSum.y, &mag);
-    if (mag > 0)
-    {
-        Normalize(&edgeSum.x, &edgeSum.y);
-        edgeSum.x = edgeSum.x * MAX_SPEED - boid->velx;
-        edgeSum.y = edgeSum.y * MAX_SPEED - boid->vely;
-        LimitVector(&edgeSum.x, &edgeSum.y, 0, MAX_WALL_FORCE);
-    }
-    
-    boid->velx += edgeSum.x;
-    boid->vely += edgeSum.y;
-}
-
-// Function to handle mouse clicks and update grid
-void HandleMouseClick(Grid* grid, int mouseX, int mouseY) {
-    int col = mouseX / CELL_SIZE;
-    int row = mouseY / CELL_SIZE;
-
-    if (row >= 0 && row < grid->rows && col >= 0 && col < grid->cols) {
-        grid->cells[row][col].state = 1;  // Example: Set to burning on click
-        printf("Cell at (%d, %d) set to burning\n", row, col);
-    }
-}
-
-int main()
-{
-    srand(time(NULL));  // Random seed
-
-    // Set number of boids to start and sections of map
-    unsigned int numBoids = MIN_BOID_NUM;
-    const unsigned int numSectionsX = 5;
-    const unsigned int numSectionsY = 5;
-
-    Boid* boids = InitializeBoids(numBoids);
-
-    // Define home targets
-    HomeTarget homeTargets[NUM_HOME_TARGETS] = {
-        {200, 100},
-        {1600, 100},
-        {200, 900},
-        {1500, 600},
-    };
-
-    Grid grid;
-    InitializeGrid(&grid);
-
-    float totalBurning = 0;
-
-    // Initialize spreadProbability and randomness control variables
-    float spreadProbability = MIN_SPREAD_PROBABILITY;
-    unsigned int updateFrequency = MIN_SPREAD_FREQ_COUNT;
-    unsigned int iterationCounter = 0;
-
-    // Allocate memory for sectionIntensity
-    float **sectionIntensity = (float **)malloc(numSectionsX * sizeof(float *));
-    for (unsigned int index = 0; index < numSectionsX; index++)
-    {
-        sectionIntensity[index] = (float *)malloc(numSectionsY * sizeof(float));
-    }
-
-    SDL_Window *window = NULL;
-    SDL_Renderer *renderer = NULL;
-    InitDisplay(&window, &renderer);
-
-    SDL_Event event;
-    bool isRunning = true;
-    bool mouseHeld = false;
-    Uint32 lastFireSpawnTime = 0; // Track last fire spawn time
-
-    while (isRunning)
-    {
-        Uint32 startTime = SDL_GetTicks();  // Start timing the frame
-
-        while (SDL_PollEvent(&event))
-        {
-            if (event.type == SDL_QUIT)
-            {
-                isRunning = false;
-            }
-            else if (event.type == SDL_MOUSEBUTTONDOWN)
-            {
-                if (event.button.button == SDL_BUTTON_LEFT)
-                {
-                    mouseHeld = true;  // Mouse is held down
-                }
-            }
-            else if (event.type == SDL_MOUSEBUTTONUP)
-            {
-                if (event.button.button == SDL_BUTTON_LEFT)
-                {
-                    mouseHeld = false;  // Mouse is released
-                }
-            }
-        }
-
-        // Limit fire spawn rate to every 50ms
-        if (mouseHeld && SDL_GetTicks() - lastFireSpawnTime > 30)
-        {
-            int mouseX, mouseY;
-            SDL_GetMouseState(&mouseX, &mouseY);
-
-            int cellX = mouseX / CELL_SIZE;
-            int cellY = mouseY / CELL_SIZE;
-
-            if (cellX >= 0 && cellX < grid.cols && cellY >= 0 && cellY < grid.rows)
-            {
-                grid.cells[cellY][cellX].state = 1;  // Set to burning
-                grid.cells[cellY][cellX].timer = BURNING_DURATION;
-            }
-
-            lastFireSpawnTime = SDL_GetTicks(); // Update last spawn time
+            *flags &= ~BOID_HEADING_HOME;
+            swarm->energy[index] = MAX_ENERGY;
         }
-
-        // Adjust spreadProbability occasionally
-        if (++iterationCounter >= updateFrequency)
-        {
-            spreadProbability = GetRandomFloat(MIN_SPREAD_PROBABILITY, MAX_SPREAD_PROBABILITY);
-            updateFrequency = GetRandomFloat(MIN_SPREAD_FREQ_COUNT, MAX_SPREAD_FREQ_COUNT);
-            iterationCounter = 0;
-        }
-
-        // Add boids if more are needed
-        if (totalBurning * SPAWN_FACTOR > numBoids && numBoids < MAX_BOID_NUM)
-        {
-            for (unsigned int index = 0; index < NUM_HOME_TARGETS; index++)
-            {
-                boids = AddBoid(boids, &numBoids, homeTargets[index].x, homeTargets[index].y);
-            }
-        }
-
-        // Remove boids if less are needed
-        if ((numBoids > totalBurning * SPAWN_FACTOR) && (numBoids > MIN_BOID_NUM))
-        {
-            float randIndex = GetRandomFloat(0, numBoids - 1);
-            boids[(int)randIndex].headingHome = true;
-            boids[(int)randIndex].headingHomeToBeRemoved = true;
-        }
-
-        UpdateGridAndCalculateIntensity(&grid, sectionIntensity, boids, numBoids,
-                                        numSectionsX, numSectionsY, &totalBurning, spreadProbability);
-        RenderGrid(renderer, &grid);
-        RenderHomeTargets(renderer, homeTargets, NUM_HOME_TARGETS);
-        for (unsigned int index = 0; index < numBoids; index++)
-        {
-            Edges(&boids[index]);
-            UpdateBoid(&boids[index], boids, numBoids, homeTargets, &grid, numSectionsX, numSectionsY, sectionIntensity);
-            boids = RemoveBoid(boids, &numBoids, index);
-        }
-
-        RenderBoids(renderer, boids, numBoids);
-
-        // Measure frame time
-        Uint32 frameTime = SDL_GetTicks() - startTime;
-
-        // Cap frame rate
-        if (frameTime < CAP_FRAME_TIME)
-        {
-            SDL_Delay(CAP_FRAME_TIME - frameTime);
-        }
-    }
-
-    CleanupDisplay(window, renderer);
-
-    // Free memory
-    for (unsigned int index = 0; index < numSectionsX; index++)
-    {
-        free(sectionIntensity[index]);
     }
-    free(sectionIntensity);
-
-    free(boids);
-
-    return 0;
 }
@@ -3,7 +3,7 @@
  * Project:        Boid Swarm Firefight
  * Author:         Peter Ryseck
  * Date Created:   February 8, 2025
- * Last Updated:   February 8, 2025
+ * Last Updated:   October 16, 2026
  *
  * Description:    Boid logic
  ******************************************************/
@@ -14,16 +14,34 @@
 #include <assert.h>
 #include <stdbool.h>
 
+#define BOID_HEADING_HOME 0x01     // Returning to a home target to refuel
+#define BOID_TO_BE_REMOVED 0x02    // Returning home to be removed from the swarm
+
+#define BOID_ALIGNMENT 32          // Byte alignment of the swarm arrays, one AVX2 register
+#define BOID_BATCH 8               // Capacities are rounded to this many boids so kernels can run whole batches
+#define MAX_SWARM_CAPACITY (1u << 28) // Largest swarm ReserveSwarm accepts, keeps capacity arithmetic far from wrapping
+
+// Structure-of-arrays boid storage, index i across the arrays is one boid
 typedef struct {
-    float posx, posy;
-    float velx, vely;
-    float energy;
-    bool headingHome;
-    bool headingHomeToBeRemoved;
-} Boid;
+    float* posx;
+    float* posy;
+    float* velx;
+    float* vely;
+    float* energy;
+    unsigned char* flags;      // BOID_HEADING_HOME | BOID_TO_BE_REMOVED
+    unsigned int count;
+    unsigned int capacity;     // Multiple of BOID_BATCH, slots past count are padding
+} Swarm;
 
 typedef struct {
     float x, y;
 } SteerForce;
 
+void InitializeSwarm(Swarm* swarm, const unsigned int numBoids, float width, float height);
+void ReserveSwarm(Swarm* swarm, unsigned int capacity);
+void AddBoid(Swarm* swarm, unsigned int locationX, unsigned int locationY);
+void RemoveBoid(Swarm* swarm, unsigned int indexToRemove);
+void RemoveFlaggedBoids(Swarm* swarm);
+void FreeSwarm(Swarm* swarm);
+
 #endif
@@ -0,0 +1,827 @@
+/******************************************************
+ * File:           boidsim.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    CPython extension over the simulation core, boid arrays and cells as zero-copy buffers
+ * Compile: gcc -O3 -march=native -shared -fPIC $(python3-config --includes) -o boidsim$(python3-config --extension-suffix) boidsim.c simulation.c boid.c utils.c environment.c bitfire.c spatial_hash.c kernels.c rng.c threadpool.c section_pyramid.c chunks.c checkpoint.c profile.c -lm -lpthread
+ * Usage:   import boidsim; sim = boidsim.Simulation(seed=42); sim.ignite(85, 150); sim.step(1000)
+ ******************************************************/
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#include "simulation.h"
+#include "checkpoint.h"
+#include "rng.h"
+#include "constants.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define STEP_BATCH 1024  // Steps between checks for Ctrl-C, the GIL is released while they run
+
+static const char* engineNames[] = {"dense", "sparse", "bitsliced"};
+
+// The core's random seed is process-wide, so simulations take turns: each one brings its own streams
+// in before it draws and takes them back out afterwards
+static pthread_mutex_t coreLock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+    PyObject_HEAD
+    Simulation sim;
+    bool initialized;
+    uint64_t rngSeed;                      // Seed of the random streams, differs from sim.seed after a fork
+    uint64_t rngCounters[RNG_STREAM_COUNT];
+    unsigned char* cells;                  // Cell states, row * cols + col, allocated on first access
+    Py_ssize_t exports;                    // Buffers handed out that still point into this simulation
+} SimulationObject;
+
+typedef enum {
+    ARRAY_POSX,
+    ARRAY_POSY,
+    ARRAY_VELX,
+    ARRAY_VELY,
+    ARRAY_ENERGY,
+    ARRAY_FLAGS,
+    ARRAY_CELLS
+} ArrayKind;
+
+// Buffer exporter for one array of a simulation, wrapped in a memoryview for the caller
+typedef struct {
+    PyObject_HEAD
+    SimulationObject* owner;
+    ArrayKind kind;
+} ArrayObject;
+
+static PyTypeObject SimulationType;
+static PyTypeObject ArrayType;
+
+static void UseRandomStreams(SimulationObject* self)
+{
+    SeedRandom(self->rngSeed);
+    for (unsigned int subsystem = 0; subsystem < RNG_STREAM_COUNT; subsystem++)
+    {
+        GetRngStream(subsystem)->counter = self->rngCounters[subsystem];
+    }
+}
+
+static void KeepRandomStreams(SimulationObject* self)
+{
+    self->rngSeed = GetRandomSeed();
+    for (unsigned int subsystem = 0; subsystem < RNG_STREAM_COUNT; subsystem++)
+    {
+        self->rngCounters[subsystem] = GetRngStream(subsystem)->counter;
+    }
+}
+
+// The bindings are this grid's only render reader, changed rows are copied into the states buffer
+static void RefreshCells(SimulationObject* self)
+{
+    Grid* grid = &self->sim.grid;
+    if (!self->cells)
+    {
+        return;
+    }
+    for (unsigned int row = 0; row < grid->rows; row++)
+    {
+        if (grid->dirtyRows[row] & DIRTY_ROW_RENDER)
+        {
+            grid->dirtyRows[row] &= ~DIRTY_ROW_RENDER;
+            unsigned char* cells = self->cells + (size_t)row * grid->cols;
+            for (unsigned int col = 0; col < grid->cols; col++)
+            {
+                cells[col] = GetCellState(grid, row, col);
+            }
+        }
+    }
+}
+
+static bool CheckInitialized(SimulationObject* self)
+{
+    if (!self->initialized)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Simulation is not initialized");
+        return false;
+    }
+    return true;
+}
+
+static bool CheckCell(SimulationObject* self, long row, long col)
+{
+    if (row < 0 || col < 0 || row >= self->sim.grid.rows || col >= self->sim.grid.cols)
+    {
+        PyErr_Format(PyExc_IndexError, "Cell (%ld, %ld) is outside the %ux%u world", row, col,
+                     self->sim.grid.cols, self->sim.grid.rows);
+        return false;
+    }
+    return true;
+}
+
+static int ParseEngine(const char* name, FireEngine* engine)
+{
+    for (unsigned int index = 0; index < 3; index++)
+    {
+        if (strcmp(name, engineNames[index]) == 0)
+        {
+            *engine = (FireEngine)index;
+            return 0;
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "Unknown fire engine '%s', expected dense, sparse or bitsliced", name);
+    return -1;
+}
+
+static void FreeSimulationObject(SimulationObject* self)
+{
+    if (self->initialized)
+    {
+        FreeSimulation(&self->sim);
+        self->initialized = false;
+    }
+    PyMem_Free(self->cells);
+    self->cells = NULL;
+}
+
+static void Simulation_dealloc(SimulationObject* self)
+{
+    FreeSimulationObject(self);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static int Simulation_init(SimulationObject* self, PyObject* args, PyObject* kwargs)
+{
+    static char* keywords[] = {"seed", "engine", "cols", "rows", "threads", NULL};
+    unsigned long long seed = 0;
+    const char* engineName = engineNames[FIRE_ENGINE];
+    unsigned int cols = GRID_WIDTH;
+    unsigned int rows = 0;
+    unsigned int threads = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|KsIII", keywords, &seed, &engineName, &cols, &rows, &threads))
+    {
+        return -1;
+    }
+
+    FireEngine engine;
+    if (ParseEngine(engineName, &engine) != 0)
+    {
+        return -1;
+    }
+    if (rows == 0)
+    {
+        uint64_t aspectRows = (uint64_t)cols * GRID_HEIGHT / GRID_WIDTH;  // Screen aspect ratio, as in boid-headless
+        if (aspectRows > UINT32_MAX)
+        {
+            PyErr_Format(PyExc_OverflowError, "%u columns at the screen aspect ratio is over %u rows, pass rows", cols,
+                         UINT32_MAX);
+            return -1;
+        }
+        rows = (unsigned int)aspectRows;
+    }
+    if (cols < 16 || rows < 16)
+    {
+        PyErr_SetString(PyExc_ValueError, "World must be at least 16 by 16 cells");
+        return -1;
+    }
+    if (!IsWorldSizeSupported(engine, cols, rows))
+    {
+        PyErr_Format(PyExc_ValueError, "World of %ux%u cells is too large for the %s engine, use sparse", cols, rows,
+                     engineName);
+        return -1;
+    }
+    if (self->exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "Simulation has arrays in use");
+        return -1;
+    }
+
+    pthread_mutex_lock(&coreLock);
+    FreeSimulationObject(self);
+    InitializeSimulationThreads(&self->sim, seed, engine, cols, rows, threads > 0 ? threads : NUM_THREADS);
+    KeepRandomStreams(self);
+    pthread_mutex_unlock(&coreLock);
+    self->initialized = true;
+    return 0;
+}
+
+// Runs steps with the GIL released, a batch at a time so Ctrl-C can stop a long run between batches
+static PyObject* Simulation_step(SimulationObject* self, PyObject* args)
+{
+    unsigned long long steps = 1;
+    if (!CheckInitialized(self) || !PyArg_ParseTuple(args, "|K", &steps))
+    {
+        return NULL;
+    }
+
+    while (steps > 0)
+    {
+        unsigned int batch = (steps < STEP_BATCH) ? (unsigned int)steps : STEP_BATCH;
+        Py_BEGIN_ALLOW_THREADS
+        pthread_mutex_lock(&coreLock);
+        UseRandomStreams(self);
+        StepSimulation(&self->sim, batch);
+        KeepRandomStreams(self);
+        pthread_mutex_unlock(&coreLock);
+        Py_END_ALLOW_THREADS
+        steps -= batch;
+
+        if (PyErr_CheckSignals() != 0)
+        {
+            RefreshCells(self);
+            return NULL;
+        }
+    }
+    RefreshCells(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject* Simulation_ignite(SimulationObject* self, PyObject* args)
+{
+    long row, col;
+    if (!CheckInitialized(self) || !PyArg_ParseTuple(args, "ll", &row, &col) || !CheckCell(self, row, col))
+    {
+        return NULL;
+    }
+    pthread_mutex_lock(&coreLock);
+    IgniteCell(&self->sim.grid, (unsigned int)row, (unsigned int)col);
+    pthread_mutex_unlock(&coreLock);
+    RefreshCells(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject* Simulation_ignite_at(SimulationObject* self, PyObject* args)
+{
+    int x, y;
+    if (!CheckInitialized(self) || !PyArg_ParseTuple(args, "ii", &x, &y))
+    {
+        return NULL;
+    }
+    pthread_mutex_lock(&coreLock);
+    IgniteAtPoint(&self->sim, x, y);
+    pthread_mutex_unlock(&coreLock);
+    RefreshCells(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject* Simulation_extinguish(SimulationObject* self, PyObject* args)
+{
+    long row, col;
+    if (!CheckInitialized(self) || !PyArg_ParseTuple(args, "ll", &row, &col) || !CheckCell(self, row, col))
+    {
+        return NULL;
+    }
+    pthread_mutex_lock(&coreLock);
+    if (GetCellState(&self->sim.grid, (unsigned int)row, (unsigned int)col) == 1)
+    {
+        ExtinguishCell(&self->sim.grid, (unsigned int)row, (unsigned int)col);
+    }
+    pthread_mutex_unlock(&coreLock);
+    RefreshCells(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject* Simulation_save(SimulationObject* self, PyObject* args)
+{
+    const char* path;
+    if (!CheckInitialized(self) || !PyArg_ParseTuple(args, "s", &path))
+    {
+        return NULL;
+    }
+
+    bool saved;
+    Py_BEGIN_ALLOW_THREADS
+    pthread_mutex_lock(&coreLock);
+    UseRandomStreams(self);
+    saved = SaveCheckpoint(&self->sim, path);
+    pthread_mutex_unlock(&coreLock);
+    Py_END_ALLOW_THREADS
+    if (!saved)
+    {
+        return PyErr_Format(PyExc_OSError, "Could not save checkpoint %s", path);
+    }
+    Py_RETURN_NONE;
+}
+
+// Resumes from a checkpoint, a seed forks the run onto new random streams as boid-headless --load does
+static PyObject* Simulation_load(PyTypeObject* type, PyObject* args, PyObject* kwargs)
+{
+    static char* keywords[] = {"path", "seed", NULL};
+    const char* path;
+    PyObject* seedObject = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|O", keywords, &path, &seedObject))
+    {
+        return NULL;
+    }
+    unsigned long long seed = 0;
+    if (seedObject != Py_None)
+    {
+        seed = PyLong_AsUnsignedLongLong(seedObject);
+        if (PyErr_Occurred())
+        {
+            return NULL;
+        }
+    }
+
+    SimulationObject* self = (SimulationObject*)type->tp_alloc(type, 0);
+    if (!self)
+    {
+        return NULL;
+    }
+
+    bool loaded;
+    Py_BEGIN_ALLOW_THREADS
+    pthread_mutex_lock(&coreLock);
+    loaded = LoadCheckpoint(&self->sim, path);
+    if (loaded && seedObject != Py_None)
+    {
+        self->sim.seed = seed;
+        SeedRandom(seed);
+    }
+    if (loaded)
+    {
+        KeepRandomStreams(self);
+    }
+    pthread_mutex_unlock(&coreLock);
+    Py_END_ALLOW_THREADS
+    if (!loaded)
+    {
+        Py_DECREF(self);
+        return PyErr_Format(PyExc_OSError, "Could not load checkpoint %s", path);
+    }
+    self->initialized = true;
+    return (PyObject*)self;
+}
+
+static PyObject* Simulation_stats(SimulationObject* self, PyObject* unused)
+{
+    (void)unused;
+    if (!CheckInitialized(self))
+    {
+        return NULL;
+    }
+    SimulationStats stats;
+    GetSimulationStats(&self->sim, &stats);
+    return Py_BuildValue("{s:K,s:K,s:K,s:K,s:I,s:I,s:I,s:I,s:f,s:d}",
+                         "unburnt", stats.unburnt, "burning", stats.burning, "burnt", stats.burnt,
+                         "extinguished", stats.extinguished, "live_chunks", stats.liveChunks,
+                         "packed_chunks", stats.packedChunks, "boids", stats.boids,
+                         "boids_heading_home", stats.boidsHeadingHome, "total_burning", self->sim.totalBurning,
+                         "energy_spent", self->sim.energySpent);
+}
+
+// [x][y] section intensities from the last step, small enough to copy
+static PyObject* Simulation_section_intensity(SimulationObject* self, PyObject* unused)
+{
+    (void)unused;
+    if (!CheckInitialized(self))
+    {
+        return NULL;
+    }
+    PyObject* columns = PyList_New(self->sim.numSectionsX);
+    for (unsigned int sectionX = 0; columns && sectionX < self->sim.numSectionsX; sectionX++)
+    {
+        PyObject* column = PyList_New(self->sim.numSectionsY);
+        if (!column)
+        {
+            Py_CLEAR(columns);
+            break;
+        }
+        for (unsigned int sectionY = 0; sectionY < self->sim.numSectionsY; sectionY++)
+        {
+            PyList_SET_ITEM(column, sectionY, PyFloat_FromDouble(self->sim.sectionIntensity[sectionX][sectionY]));
+        }
+        PyList_SET_ITEM(columns, sectionX, column);
+    }
+    return columns;
+}
+
+// rows x cols states from (row, col) as bytes, row by row, read off the grid without the cells mirror
+static PyObject* Simulation_cells_window(SimulationObject* self, PyObject* args)
+{
+    long row, col, rows, cols;
+    if (!CheckInitialized(self) || !PyArg_ParseTuple(args, "llll", &row, &col, &rows, &cols) ||
+        !CheckCell(self, row, col))
+    {
+        return NULL;
+    }
+    const Grid* grid = &self->sim.grid;
+    if (rows < 1 || cols < 1 || rows > (long)grid->rows - row || cols > (long)grid->cols - col)
+    {
+        PyErr_Format(PyExc_IndexError, "Window of %ldx%ld cells at (%ld, %ld) is outside the %ux%u world", cols, rows,
+                     row, col, grid->cols, grid->rows);
+        return NULL;
+    }
+    if ((uint64_t)rows * cols > FULL_GRID_MAX_CELLS)
+    {
+        PyErr_Format(PyExc_MemoryError, "Window of %ldx%ld cells is over the limit of %llu cells", cols, rows,
+                     (unsigned long long)FULL_GRID_MAX_CELLS);
+        return NULL;
+    }
+
+    PyObject* window = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)(rows * cols));
+    if (!window)
+    {
+        return NULL;
+    }
+    unsigned char* states = (unsigned char*)PyBytes_AS_STRING(window);
+    pthread_mutex_lock(&coreLock);
+    for (long windowRow = 0; windowRow < rows; windowRow++)
+    {
+        for (long windowCol = 0; windowCol < cols; windowCol++)
+        {
+            states[windowRow * cols + windowCol] =
+                GetCellState(grid, (unsigned int)(row + windowRow), (unsigned int)(col + windowCol));
+        }
+    }
+    pthread_mutex_unlock(&coreLock);
+    return window;
+}
+
+static PyObject* NewArray(SimulationObject* owner, ArrayKind kind)
+{
+    if (!CheckInitialized(owner))
+    {
+        return NULL;
+    }
+    if (kind == ARRAY_CELLS && !owner->cells)
+    {
+        // The mirror holds a byte per cell of the whole world, chunked worlds past that read cells_window
+        Grid* grid = &owner->sim.grid;
+        if ((uint64_t)grid->rows * grid->cols > FULL_GRID_MAX_CELLS)
+        {
+            PyErr_Format(PyExc_MemoryError, "A %ux%u world is too large for the cells array, use cells_window",
+                         grid->cols, grid->rows);
+            return NULL;
+        }
+        owner->cells = (unsigned char*)PyMem_Malloc((size_t)grid->rows * grid->cols);
+        if (!owner->cells)
+        {
+            return PyErr_NoMemory();
+        }
+        for (unsigned int row = 0; row < grid->rows; row++)
+        {
+            grid->dirtyRows[row] |= DIRTY_ROW_RENDER;
+        }
+        RefreshCells(owner);
+    }
+
+    ArrayObject* array = PyObject_New(ArrayObject, &ArrayType);
+    if (!array)
+    {
+        return NULL;
+    }
+    Py_INCREF(owner);
+    array->owner = owner;
+    array->kind = kind;
+    PyObject* view = PyMemoryView_FromObject((PyObject*)array);
+    Py_DECREF(array);
+    return view;
+}
+
+static PyObject* Simulation_get_array(SimulationObject* self, void* closure)
+{
+    return NewArray(self, (ArrayKind)(intptr_t)closure);
+}
+
+static PyObject* Simulation_get_frame(SimulationObject* self, void* closure)
+{
+    (void)closure;
+    return CheckInitialized(self) ? PyLong_FromUnsignedLongLong(self->sim.frame) : NULL;
+}
+
+static PyObject* Simulation_get_seed(SimulationObject* self, void* closure)
+{
+    (void)closure;
+    return CheckInitialized(self) ? PyLong_FromUnsignedLongLong(self->sim.seed) : NULL;
+}
+
+static PyObject* Simulation_get_engine(SimulationObject* self, void* closure)
+{
+    (void)closure;
+    return CheckInitialized(self) ? PyUnicode_FromString(engineNames[self->sim.grid.engine]) : NULL;
+}
+
+static PyObject* Simulation_get_cols(SimulationObject* self, void* closure)
+{
+    (void)closure;
+    return CheckInitialized(self) ? PyLong_FromUnsignedLong(self->sim.grid.cols) : NULL;
+}
+
+static PyObject* Simulation_get_rows(SimulationObject* self, void* closure)
+{
+    (void)closure;
+    return CheckInitialized(self) ? PyLong_FromUnsignedLong(self->sim.grid.rows) : NULL;
+}
+
+static PyObject* Simulation_get_boid_count(SimulationObject* self, void* closure)
+{
+    (void)closure;
+    return CheckInitialized(self) ? PyLong_FromUnsignedLong(self->sim.swarm.count) : NULL;
+}
+
+static PyObject* Simulation_get_home_targets(SimulationObject* self, void* closure)
+{
+    (void)closure;
+    if (!CheckInitialized(self))
+    {
+        return NULL;
+    }
+    PyObject* targets = PyTuple_New(NUM_HOME_TARGETS);
+    for (unsigned int target = 0; targets && target < NUM_HOME_TARGETS; target++)
+    {
+        PyTuple_SET_ITEM(targets, target, Py_BuildValue("(ii)", self->sim.homeTargets[target].x,
+                                                        self->sim.homeTargets[target].y));
+    }
+    return targets;
+}
+
+// Tunable settings, defaults from constants.h
+typedef enum {
+    SETTING_SPAWN_FACTOR,
+    SETTING_MAX_FORCE_TARGET,
+    SETTING_FIRE_INTENSITY_BIAS,
+    SETTING_IGNITION_PROBABILITY
+} FloatSetting;
+
+static float* GetFloatSetting(SimulationObject* self, FloatSetting setting)
+{
+    switch (setting)
+    {
+        case SETTING_SPAWN_FACTOR: return &self->sim.spawnFactor;
+        case SETTING_MAX_FORCE_TARGET: return &self->sim.maxForceTarget;
+        case SETTING_FIRE_INTENSITY_BIAS: return &self->sim.grid.fireIntensityBias;
+        default: return &self->sim.grid.ignitionProbability;
+    }
+}
+
+static PyObject* Simulation_get_setting(SimulationObject* self, void* closure)
+{
+    return CheckInitialized(self) ? PyFloat_FromDouble(*GetFloatSetting(self, (FloatSetting)(intptr_t)closure)) : NULL;
+}
+
+static int Simulation_set_setting(SimulationObject* self, PyObject* value, void* closure)
+{
+    if (!CheckInitialized(self))
+    {
+        return -1;
+    }
+    if (!value)
+    {
+        PyErr_SetString(PyExc_AttributeError, "Settings cannot be deleted");
+        return -1;
+    }
+    double number = PyFloat_AsDouble(value);
+    if (number == -1.0 && PyErr_Occurred())
+    {
+        return -1;
+    }
+    *GetFloatSetting(self, (FloatSetting)(intptr_t)closure) = (float)number;
+    return 0;
+}
+
+static PyObject* Simulation_get_min_boids(SimulationObject* self, void* closure)
+{
+    (void)closure;
+    return CheckInitialized(self) ? PyLong_FromUnsignedLong(self->sim.minBoids) : NULL;
+}
+
+// Swarm bounds leave room for the home targets under MAX_SWARM_CAPACITY, larger ones raise OverflowError
+static int ParseSwarmSize(PyObject* value, unsigned int* count)
+{
+    if (!value)
+    {
+        PyErr_SetString(PyExc_AttributeError, "Settings cannot be deleted");
+        return -1;
+    }
+    unsigned long long number = PyLong_AsUnsignedLongLong(value);
+    if (PyErr_Occurred())
+    {
+        return -1;
+    }
+    if (number > MAX_SWARM_CAPACITY - NUM_HOME_TARGETS)
+    {
+        PyErr_Format(PyExc_OverflowError, "Swarm size %llu is over the limit of %u", number,
+                     MAX_SWARM_CAPACITY - NUM_HOME_TARGETS);
+        return -1;
+    }
+    *count = (unsigned int)number;
+    return 0;
+}
+
+static int Simulation_set_min_boids(SimulationObject* self, PyObject* value, void* closure)
+{
+    (void)closure;
+    unsigned int count;
+    if (!CheckInitialized(self) || ParseSwarmSize(value, &count) != 0)
+    {
+        return -1;
+    }
+    self->sim.minBoids = count;
+    return 0;
+}
+
+static PyObject* Simulation_get_max_boids(SimulationObject* self, void* closure)
+{
+    (void)closure;
+    return CheckInitialized(self) ? PyLong_FromUnsignedLong(self->sim.maxBoids) : NULL;
+}
+
+// Spawning must never allocate, so a larger cap grows the swarm arrays now; they may move, which is only
+// allowed while no array is in use
+static int Simulation_set_max_boids(SimulationObject* self, PyObject* value, void* closure)
+{
+    (void)closure;
+    unsigned int count;
+    if (!CheckInitialized(self) || ParseSwarmSize(value, &count) != 0)
+    {
+        return -1;
+    }
+    uint64_t capacity = (uint64_t)count + NUM_HOME_TARGETS;
+    if (capacity > self->sim.swarm.capacity && self->exports > 0)
+    {
+        PyErr_SetString(PyExc_BufferError, "Growing max_boids moves the boid arrays, release them first");
+        return -1;
+    }
+    pthread_mutex_lock(&coreLock);
+    self->sim.maxBoids = count;
+    ReserveSwarm(&self->sim.swarm, (unsigned int)capacity);
+    pthread_mutex_unlock(&coreLock);
+    return 0;
+}
+
+static PyMethodDef simulationMethods[] = {
+    {"step", (PyCFunction)Simulation_step, METH_VARARGS, "step(n=1)\nAdvance the simulation n steps."},
+    {"ignite", (PyCFunction)Simulation_ignite, METH_VARARGS, "ignite(row, col)\nSet a cell burning."},
+    {"ignite_at", (PyCFunction)Simulation_ignite_at, METH_VARARGS,
+     "ignite_at(x, y)\nSet the cell under a pixel position burning, positions off the map are ignored."},
+    {"extinguish", (PyCFunction)Simulation_extinguish, METH_VARARGS, "extinguish(row, col)\nPut out a burning cell."},
+    {"save", (PyCFunction)Simulation_save, METH_VARARGS, "save(path)\nWrite a checkpoint of the whole run."},
+    {"load", (PyCFunction)(void (*)(void))Simulation_load, METH_VARARGS | METH_KEYWORDS | METH_CLASS,
+     "Simulation.load(path, seed=None)\nResume from a checkpoint, a seed forks the run onto new random streams."},
+    {"cells_window", (PyCFunction)Simulation_cells_window, METH_VARARGS,
+     "cells_window(row, col, rows, cols)\nCell states of a block of the world as rows * cols bytes, row by row."},
+    {"stats", (PyCFunction)Simulation_stats, METH_NOARGS, "stats()\nCell counts by state, chunk and boid counts."},
+    {"section_intensity", (PyCFunction)Simulation_section_intensity, METH_NOARGS,
+     "section_intensity()\nSection intensities of the last step, indexed [x][y]."},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef simulationGetSet[] = {
+    {"posx", (getter)Simulation_get_array, NULL, "Boid x positions in pixels, float32", (void*)ARRAY_POSX},
+    {"posy", (getter)Simulation_get_array, NULL, "Boid y positions in pixels, float32", (void*)ARRAY_POSY},
+    {"velx", (getter)Simulation_get_array, NULL, "Boid x velocities, float32", (void*)ARRAY_VELX},
+    {"vely", (getter)Simulation_get_array, NULL, "Boid y velocities, float32", (void*)ARRAY_VELY},
+    {"energy", (getter)Simulation_get_array, NULL, "Boid energy, float32", (void*)ARRAY_ENERGY},
+    {"flags", (getter)Simulation_get_array, NULL, "Boid flags, uint8", (void*)ARRAY_FLAGS},
+    {"cells", (getter)Simulation_get_array, NULL,
+     "Cell states as a rows x cols uint8 array: 0 unburnt, 1 burning, 2 burnt, 3 extinguished. A copy kept by the "
+     "bindings, updated from the changed rows after every step, ignite and extinguish. Worlds over "
+     "FULL_GRID_MAX_CELLS raise MemoryError, read them with cells_window", (void*)ARRAY_CELLS},
+    {"frame", (getter)Simulation_get_frame, NULL, "Steps taken so far", NULL},
+    {"seed", (getter)Simulation_get_seed, NULL, "Seed the run started from", NULL},
+    {"engine", (getter)Simulation_get_engine, NULL, "Fire engine name", NULL},
+    {"cols", (getter)Simulation_get_cols, NULL, "World width in cells", NULL},
+    {"rows", (getter)Simulation_get_rows, NULL, "World height in cells", NULL},
+    {"boid_count", (getter)Simulation_get_boid_count, NULL, "Boids in the swarm", NULL},
+    {"home_targets", (getter)Simulation_get_home_targets, NULL, "Home target positions in pixels", NULL},
+    {"spawn_factor", (getter)Simulation_get_setting, (setter)Simulation_set_setting,
+     "Boids wanted per burning cell", (void*)SETTING_SPAWN_FACTOR},
+    {"max_force_target", (getter)Simulation_get_setting, (setter)Simulation_set_setting,
+     "Steering force towards fires and home", (void*)SETTING_MAX_FORCE_TARGET},
+    {"fire_intensity_bias", (getter)Simulation_get_setting, (setter)Simulation_set_setting,
+     "Section intensity per burning cell", (void*)SETTING_FIRE_INTENSITY_BIAS},
+    {"ignition_probability", (getter)Simulation_get_setting, (setter)Simulation_set_setting,
+     "Chance of a random ignition per step", (void*)SETTING_IGNITION_PROBABILITY},
+    {"min_boids", (getter)Simulation_get_min_boids, (setter)Simulation_set_min_boids, "Smallest swarm", NULL},
+    {"max_boids", (getter)Simulation_get_max_boids, (setter)Simulation_set_max_boids, "Largest swarm", NULL},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyTypeObject SimulationType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "boidsim.Simulation",
+    .tp_doc = PyDoc_STR("Simulation(seed=0, engine='sparse', cols=GRID_WIDTH, rows=screen aspect, threads=0)\n"
+                        "One run of the boid firefight. Array attributes are zero-copy memoryviews of the current "
+                        "swarm and grid; take new ones after step() to see boids added or removed."),
+    .tp_basicsize = sizeof(SimulationObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc)Simulation_init,
+    .tp_dealloc = (destructor)Simulation_dealloc,
+    .tp_methods = simulationMethods,
+    .tp_getset = simulationGetSet,
+};
+
+// Shape and strides live in view->internal until the buffer is released
+static int Array_getbuffer(ArrayObject* self, Py_buffer* view, int flags)
+{
+    SimulationObject* owner = self->owner;
+    Swarm* swarm = &owner->sim.swarm;
+    Py_ssize_t* layout = (Py_ssize_t*)PyMem_Malloc(4 * sizeof(Py_ssize_t));
+    if (!layout)
+    {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    view->readonly = 0;
+    view->ndim = 1;
+    view->shape = layout;
+    view->strides = layout + 2;
+    view->suboffsets = NULL;
+    view->internal = layout;
+
+    if (self->kind == ARRAY_CELLS)
+    {
+        view->buf = owner->cells;
+        view->itemsize = 1;
+        view->format = "B";
+        view->ndim = 2;
+        layout[0] = owner->sim.grid.rows;
+        layout[1] = owner->sim.grid.cols;
+        layout[2] = owner->sim.grid.cols;
+        layout[3] = 1;
+    }
+    else
+    {
+        float* arrays[] = {swarm->posx, swarm->posy, swarm->velx, swarm->vely, swarm->energy};
+        view->buf = (self->kind == ARRAY_FLAGS) ? (void*)swarm->flags : (void*)arrays[self->kind];
+        view->itemsize = (self->kind == ARRAY_FLAGS) ? 1 : sizeof(float);
+        view->format = (self->kind == ARRAY_FLAGS) ? "B" : "f";
+        layout[0] = swarm->count;
+        layout[2] = view->itemsize;
+    }
+    view->len = layout[0] * ((view->ndim == 2) ? layout[1] : 1) * view->itemsize;
+    if (!(flags & PyBUF_FORMAT))
+    {
+        view->format = NULL;
+    }
+
+    view->obj = (PyObject*)self;
+    Py_INCREF(self);
+    owner->exports++;
+    return 0;
+}
+
+static void Array_releasebuffer(ArrayObject* self, Py_buffer* view)
+{
+    PyMem_Free(view->internal);
+    self->owner->exports--;
+}
+
+static void Array_dealloc(ArrayObject* self)
+{
+    Py_DECREF(self->owner);
+    PyObject_Free(self);
+}
+
+static PyBufferProcs arrayBuffer = {
+    .bf_getbuffer = (getbufferproc)Array_getbuffer,
+    .bf_releasebuffer = (releasebufferproc)Array_releasebuffer,
+};
+
+static PyTypeObject ArrayType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "boidsim.Array",
+    .tp_doc = PyDoc_STR("Buffer over one array of a Simulation"),
+    .tp_basicsize = sizeof(ArrayObject),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_dealloc = (destructor)Array_dealloc,
+    .tp_as_buffer = &arrayBuffer,
+};
+
+static struct PyModuleDef boidsimModule = {
+    PyModuleDef_HEAD_INIT,
+    .m_name = "boidsim",
+    .m_doc = PyDoc_STR("Boid firefight simulation core. Simulations in one process step one at a time, "
+                       "run separate processes to use more cores."),
+    .m_size = -1,
+};
+
+PyMODINIT_FUNC PyInit_boidsim(void)
+{
+    if (PyType_Ready(&SimulationType) < 0 || PyType_Ready(&ArrayType) < 0)
+    {
+        return NULL;
+    }
+
+    PyObject* module = PyModule_Create(&boidsimModule);
+    if (!module)
+    {
+        return NULL;
+    }
+    Py_INCREF(&SimulationType);
+    if (PyModule_AddObject(module, "Simulation", (PyObject*)&SimulationType) < 0 ||
+        PyModule_AddIntConstant(module, "BOID_HEADING_HOME", BOID_HEADING_HOME) < 0 ||
+        PyModule_AddIntConstant(module, "BOID_TO_BE_REMOVED", BOID_TO_BE_REMOVED) < 0 ||
+        PyModule_AddIntConstant(module, "CELL_SIZE", CELL_SIZE) < 0 ||
+        PyModule_AddIntConstant(module, "GRID_WIDTH", GRID_WIDTH) < 0 ||
+        PyModule_AddIntConstant(module, "GRID_HEIGHT", GRID_HEIGHT) < 0)
+    {
+        Py_DECREF(&SimulationType);
+        Py_DECREF(module);
+        return NULL;
+    }
+    return module;
+}
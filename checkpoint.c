@@ -0,0 +1,550 @@
+/******************************************************
+ * File:           checkpoint.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Binary snapshots of a whole simulation, loaded through mmap
+ ******************************************************/
+
+#include "checkpoint.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static uint64_t AlignOffset(uint64_t offset)
+{
+    return (offset + CHECKPOINT_ALIGNMENT - 1) / CHECKPOINT_ALIGNMENT * CHECKPOINT_ALIGNMENT;
+}
+
+static uint64_t GetPlaneWords(const Grid* grid)
+{
+    return (uint64_t)grid->rows * ((grid->cols + 63) / 64);
+}
+
+static bool WriteBytes(FILE* file, uint64_t* position, const void* data, uint64_t size)
+{
+    if (size > 0 && fwrite(data, 1, size, file) != size)
+    {
+        return false;
+    }
+    *position += size;
+    return true;
+}
+
+// Zero fill up to the start of the next block
+static bool WritePadding(FILE* file, uint64_t* position, uint64_t offset)
+{
+    static const unsigned char zeros[CHECKPOINT_ALIGNMENT] = {0};
+    return WriteBytes(file, position, zeros, offset - *position);
+}
+
+// Chunk records and the size of the chunk data they point into
+static CheckpointChunk* DescribeChunks(const Grid* grid, uint64_t* dataSize)
+{
+    unsigned int chunkCount = grid->chunkRows * grid->chunkCols;
+    CheckpointChunk* chunks = (CheckpointChunk*)calloc(chunkCount, sizeof(CheckpointChunk));
+    if (!chunks)
+    {
+        fprintf(stderr, "Memory allocation failed for checkpoint chunks\n");
+        exit(1);
+    }
+
+    *dataSize = 0;
+    for (unsigned int chunkIndex = 0; chunkIndex < chunkCount; chunkIndex++)
+    {
+        const ChunkSlot* slot = &grid->chunks[chunkIndex];
+        CheckpointChunk* chunk = &chunks[chunkIndex];
+        if (slot->live)
+        {
+            chunk->kind = CHECKPOINT_CHUNK_LIVE;
+            chunk->lastChange = slot->live->lastChange;
+            chunk->offset = *dataSize;
+            *dataSize += CHUNK_CELLS * sizeof(Cell);
+        }
+        else if (slot->packed)
+        {
+            chunk->kind = CHECKPOINT_CHUNK_PACKED;
+            chunk->offset = *dataSize;
+            *dataSize += CHUNK_CELLS / 4;
+        }
+        else
+        {
+            chunk->kind = CHECKPOINT_CHUNK_UNIFORM;
+            chunk->uniform = slot->uniform;
+        }
+    }
+    return chunks;
+}
+
+// Written to a temporary file and renamed into place, so a crash never leaves half a checkpoint at path
+bool SaveCheckpoint(const Simulation* sim, const char* path)
+{
+    const Grid* grid = &sim->grid;
+    const Swarm* swarm = &sim->swarm;
+    const FireFront* front = &grid->front;
+    unsigned int chunkCount = grid->chunkRows * grid->chunkCols;
+
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.byteOrder = CHECKPOINT_BYTE_ORDER;
+    header.headerSize = sizeof(CheckpointHeader);
+    header.seed = sim->seed;
+    header.frame = sim->frame;
+    for (unsigned int subsystem = 0; subsystem < RNG_STREAM_COUNT; subsystem++)
+    {
+        header.rngCounters[subsystem] = GetRngStream(subsystem)->counter;
+    }
+    header.engine = grid->engine;
+    header.cols = grid->cols;
+    header.rows = grid->rows;
+    header.numSectionsX = sim->numSectionsX;
+    header.numSectionsY = sim->numSectionsY;
+    header.tick = grid->tick;
+    header.boidCount = swarm->count;
+    header.minBoids = sim->minBoids;
+    header.maxBoids = sim->maxBoids;
+    header.updateFrequency = sim->updateFrequency;
+    header.iterationCounter = sim->iterationCounter;
+    header.spreadProbability = sim->spreadProbability;
+    header.totalBurning = sim->totalBurning;
+    header.spawnFactor = sim->spawnFactor;
+    header.maxForceTarget = sim->maxForceTarget;
+    header.ignitionProbability = grid->ignitionProbability;
+    header.fireIntensityBias = grid->fireIntensityBias;
+    for (unsigned int target = 0; target < NUM_HOME_TARGETS; target++)
+    {
+        header.homeTargets[target][0] = sim->homeTargets[target].x;
+        header.homeTargets[target][1] = sim->homeTargets[target].y;
+    }
+    memcpy(header.cellCounts, grid->cellCounts, sizeof(header.cellCounts));
+
+    uint64_t chunkDataSize;
+    CheckpointChunk* chunks = DescribeChunks(grid, &chunkDataSize);
+    uint64_t wheelEntries = 0;
+    uint32_t wheelCounts[BURNOUT_WHEEL_SIZE];
+    for (unsigned int slot = 0; slot < BURNOUT_WHEEL_SIZE; slot++)
+    {
+        wheelCounts[slot] = front->wheel[slot].count;
+        wheelEntries += wheelCounts[slot];
+    }
+    uint64_t planeWords = (grid->engine == FIRE_ENGINE_BITSLICED) ? GetPlaneWords(grid) : 0;
+
+    uint64_t sizes[CHECKPOINT_BLOCK_COUNT] = {
+        [CHECKPOINT_POSX] = swarm->count * sizeof(float),
+        [CHECKPOINT_POSY] = swarm->count * sizeof(float),
+        [CHECKPOINT_VELX] = swarm->count * sizeof(float),
+        [CHECKPOINT_VELY] = swarm->count * sizeof(float),
+        [CHECKPOINT_ENERGY] = swarm->count * sizeof(float),
+        [CHECKPOINT_FLAGS] = swarm->count * sizeof(unsigned char),
+        [CHECKPOINT_SECTION_COUNTS] = (uint64_t)sim->numSectionsX * sim->numSectionsY * CELL_STATE_COUNT * sizeof(uint64_t),
+        [CHECKPOINT_CHUNK_SLOTS] = (uint64_t)chunkCount * sizeof(CheckpointChunk),
+        [CHECKPOINT_CHUNK_DATA] = chunkDataSize,
+        [CHECKPOINT_BURNING] = (uint64_t)front->burning.count * sizeof(uint64_t),
+        [CHECKPOINT_WHEEL_COUNTS] = sizeof(wheelCounts),
+        [CHECKPOINT_WHEEL] = wheelEntries * sizeof(uint64_t),
+        [CHECKPOINT_PLANES] = (2 + BURNOUT_WHEEL_SIZE) * planeWords * sizeof(uint64_t),
+    };
+    uint64_t offset = AlignOffset(sizeof(CheckpointHeader));
+    for (unsigned int block = 0; block < CHECKPOINT_BLOCK_COUNT; block++)
+    {
+        header.blocks[block].offset = offset;
+        header.blocks[block].size = sizes[block];
+        offset = AlignOffset(offset + sizes[block]);
+    }
+    header.fileSize = offset;
+
+    size_t pathLength = strlen(path);
+    char* temporaryPath = (char*)malloc(pathLength + 5);
+    if (!temporaryPath)
+    {
+        fprintf(stderr, "Memory allocation failed for checkpoint path\n");
+        exit(1);
+    }
+    memcpy(temporaryPath, path, pathLength);
+    memcpy(temporaryPath + pathLength, ".tmp", 5);
+
+    FILE* file = fopen(temporaryPath, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Could not open checkpoint %s for writing\n", temporaryPath);
+        free(temporaryPath);
+        free(chunks);
+        return false;
+    }
+
+    uint64_t position = 0;
+    const void* arrays[CHECKPOINT_FLAGS + 1] = {swarm->posx, swarm->posy, swarm->velx, swarm->vely, swarm->energy, swarm->flags};
+    bool ok = WriteBytes(file, &position, &header, sizeof(header));
+    for (unsigned int block = CHECKPOINT_POSX; ok && block <= CHECKPOINT_FLAGS; block++)
+    {
+        ok = WritePadding(file, &position, header.blocks[block].offset) &&
+             WriteBytes(file, &position, arrays[block], sizes[block]);
+    }
+
+    ok = ok && WritePadding(file, &position, header.blocks[CHECKPOINT_SECTION_COUNTS].offset) &&
+         WriteBytes(file, &position, grid->sectionCounts, sizes[CHECKPOINT_SECTION_COUNTS]) &&
+         WritePadding(file, &position, header.blocks[CHECKPOINT_CHUNK_SLOTS].offset) &&
+         WriteBytes(file, &position, chunks, sizes[CHECKPOINT_CHUNK_SLOTS]) &&
+         WritePadding(file, &position, header.blocks[CHECKPOINT_CHUNK_DATA].offset);
+    for (unsigned int chunkIndex = 0; ok && chunkIndex < chunkCount; chunkIndex++)
+    {
+        const ChunkSlot* slot = &grid->chunks[chunkIndex];
+        if (chunks[chunkIndex].kind == CHECKPOINT_CHUNK_LIVE)
+        {
+            ok = WriteBytes(file, &position, slot->live->cells, CHUNK_CELLS * sizeof(Cell));
+        }
+        else if (chunks[chunkIndex].kind == CHECKPOINT_CHUNK_PACKED)
+        {
+            ok = WriteBytes(file, &position, slot->packed, CHUNK_CELLS / 4);
+        }
+    }
+
+    ok = ok && WritePadding(file, &position, header.blocks[CHECKPOINT_BURNING].offset) &&
+         WriteBytes(file, &position, front->burning.cells, sizes[CHECKPOINT_BURNING]) &&
+         WritePadding(file, &position, header.blocks[CHECKPOINT_WHEEL_COUNTS].offset) &&
+         WriteBytes(file, &position, wheelCounts, sizeof(wheelCounts)) &&
+         WritePadding(file, &position, header.blocks[CHECKPOINT_WHEEL].offset);
+    for (unsigned int slot = 0; ok && slot < BURNOUT_WHEEL_SIZE; slot++)
+    {
+        ok = WriteBytes(file, &position, front->wheel[slot].cells, wheelCounts[slot] * sizeof(uint64_t));
+    }
+
+    ok = ok && WritePadding(file, &position, header.blocks[CHECKPOINT_PLANES].offset);
+    if (planeWords > 0)
+    {
+        ok = ok && WriteBytes(file, &position, grid->planes.burning, planeWords * sizeof(uint64_t)) &&
+             WriteBytes(file, &position, grid->planes.unburnt, planeWords * sizeof(uint64_t));
+        for (unsigned int slot = 0; ok && slot < BURNOUT_WHEEL_SIZE; slot++)
+        {
+            ok = WriteBytes(file, &position, grid->planes.burnout[slot], planeWords * sizeof(uint64_t));
+        }
+    }
+    ok = ok && WritePadding(file, &position, header.fileSize);
+
+    if (fclose(file) != 0)
+    {
+        ok = false;
+    }
+    if (ok && rename(temporaryPath, path) != 0)
+    {
+        ok = false;
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "Could not write checkpoint %s\n", path);
+        remove(temporaryPath);
+    }
+
+    free(temporaryPath);
+    free(chunks);
+    return ok;
+}
+
+static const void* GetBlock(const unsigned char* base, const CheckpointHeader* header, CheckpointBlock block)
+{
+    return base + header->blocks[block].offset;
+}
+
+// Everything the restore relies on is checked here, before the simulation is touched
+static bool ValidateCheckpoint(const unsigned char* base, uint64_t fileSize)
+{
+    if (fileSize < sizeof(CheckpointHeader))
+    {
+        return false;
+    }
+
+    const CheckpointHeader* header = (const CheckpointHeader*)base;
+    if (memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(header->magic)) != 0 || header->version != CHECKPOINT_VERSION ||
+        header->byteOrder != CHECKPOINT_BYTE_ORDER || header->headerSize != sizeof(CheckpointHeader) ||
+        header->fileSize != fileSize || header->engine > FIRE_ENGINE_BITSLICED || header->cols < 16 || header->rows < 16 ||
+        !IsWorldSizeSupported((FireEngine)header->engine, header->cols, header->rows) ||
+        (uint64_t)header->maxBoids + NUM_HOME_TARGETS > MAX_SWARM_CAPACITY ||
+        header->boidCount > (uint64_t)header->maxBoids + NUM_HOME_TARGETS)
+    {
+        return false;
+    }
+
+    // Sections come from the build, so a checkpoint from a build with other NUM_SECTIONS cannot resume here
+    if (header->numSectionsX != ((NUM_SECTIONS_X < header->cols) ? NUM_SECTIONS_X : header->cols) ||
+        header->numSectionsY != ((NUM_SECTIONS_Y < header->rows) ? NUM_SECTIONS_Y : header->rows))
+    {
+        return false;
+    }
+
+    for (unsigned int block = 0; block < CHECKPOINT_BLOCK_COUNT; block++)
+    {
+        const CheckpointRange* range = &header->blocks[block];
+        if (range->offset % CHECKPOINT_ALIGNMENT != 0 || range->offset > fileSize || range->size > fileSize - range->offset)
+        {
+            return false;
+        }
+    }
+
+    uint64_t chunkRows = (header->rows + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    uint64_t chunkCols = (header->cols + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    uint64_t cellCount = (uint64_t)header->rows * header->cols;
+    uint64_t planeWords = (header->engine == FIRE_ENGINE_BITSLICED) ? (uint64_t)header->rows * ((header->cols + 63) / 64) : 0;
+    const CheckpointRange* blocks = header->blocks;
+    for (unsigned int block = CHECKPOINT_POSX; block <= CHECKPOINT_ENERGY; block++)
+    {
+        if (blocks[block].size != header->boidCount * sizeof(float))
+        {
+            return false;
+        }
+    }
+    if (blocks[CHECKPOINT_FLAGS].size != header->boidCount ||
+        blocks[CHECKPOINT_SECTION_COUNTS].size != (uint64_t)header->numSectionsX * header->numSectionsY * CELL_STATE_COUNT * sizeof(uint64_t) ||
+        blocks[CHECKPOINT_CHUNK_SLOTS].size != chunkRows * chunkCols * sizeof(CheckpointChunk) ||
+        blocks[CHECKPOINT_BURNING].size % sizeof(uint64_t) != 0 ||
+        blocks[CHECKPOINT_WHEEL_COUNTS].size != BURNOUT_WHEEL_SIZE * sizeof(uint32_t) ||
+        blocks[CHECKPOINT_PLANES].size != (2 + BURNOUT_WHEEL_SIZE) * planeWords * sizeof(uint64_t))
+    {
+        return false;
+    }
+
+    const CheckpointChunk* chunks = (const CheckpointChunk*)GetBlock(base, header, CHECKPOINT_CHUNK_SLOTS);
+    const unsigned char* chunkData = (const unsigned char*)GetBlock(base, header, CHECKPOINT_CHUNK_DATA);
+    uint64_t dataSize = blocks[CHECKPOINT_CHUNK_DATA].size;
+    for (uint64_t chunkIndex = 0; chunkIndex < chunkRows * chunkCols; chunkIndex++)
+    {
+        const CheckpointChunk* chunk = &chunks[chunkIndex];
+        if (chunk->kind == CHECKPOINT_CHUNK_LIVE)
+        {
+            if (chunk->offset > dataSize || CHUNK_CELLS * sizeof(Cell) > dataSize - chunk->offset)
+            {
+                return false;
+            }
+            const Cell* cells = (const Cell*)(chunkData + chunk->offset);
+            for (unsigned int offset = 0; offset < CHUNK_CELLS; offset++)
+            {
+                if (cells[offset].state >= CELL_STATE_COUNT)
+                {
+                    return false;
+                }
+            }
+        }
+        else if (header->engine == FIRE_ENGINE_DENSE)
+        {
+            return false;  // The dense engine keeps every chunk live
+        }
+        else if (chunk->kind == CHECKPOINT_CHUNK_PACKED)
+        {
+            if (chunk->offset > dataSize || CHUNK_CELLS / 4 > dataSize - chunk->offset)
+            {
+                return false;
+            }
+        }
+        else if (chunk->kind != CHECKPOINT_CHUNK_UNIFORM || chunk->uniform >= CELL_STATE_COUNT)
+        {
+            return false;
+        }
+    }
+
+    // Listed cells must be in live chunks, wheel entries only need to be on the grid
+    const uint64_t* burning = (const uint64_t*)GetBlock(base, header, CHECKPOINT_BURNING);
+    for (uint64_t entry = 0; entry < blocks[CHECKPOINT_BURNING].size / sizeof(uint64_t); entry++)
+    {
+        if (burning[entry] >= cellCount)
+        {
+            return false;
+        }
+        uint64_t row = burning[entry] / header->cols;
+        uint64_t col = burning[entry] % header->cols;
+        if (chunks[(row >> CHUNK_SHIFT) * chunkCols + (col >> CHUNK_SHIFT)].kind != CHECKPOINT_CHUNK_LIVE)
+        {
+            return false;
+        }
+    }
+
+    const uint32_t* wheelCounts = (const uint32_t*)GetBlock(base, header, CHECKPOINT_WHEEL_COUNTS);
+    uint64_t wheelEntries = 0;
+    for (unsigned int slot = 0; slot < BURNOUT_WHEEL_SIZE; slot++)
+    {
+        wheelEntries += wheelCounts[slot];
+    }
+    if (blocks[CHECKPOINT_WHEEL].size != wheelEntries * sizeof(uint64_t))
+    {
+        return false;
+    }
+    const uint64_t* wheel = (const uint64_t*)GetBlock(base, header, CHECKPOINT_WHEEL);
+    for (uint64_t entry = 0; entry < wheelEntries; entry++)
+    {
+        if (wheel[entry] >= cellCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void RestoreCellList(CellList* list, const uint64_t* cells, unsigned int count)
+{
+    list->count = count;
+    list->capacity = (count > 64) ? count : 64;
+    list->cells = (uint64_t*)realloc(list->cells, list->capacity * sizeof(uint64_t));
+    if (!list->cells)
+    {
+        fprintf(stderr, "Memory allocation failed for cell list\n");
+        exit(1);
+    }
+    memcpy(list->cells, cells, count * sizeof(uint64_t));
+}
+
+static void RestoreGrid(Grid* grid, const unsigned char* base, const CheckpointHeader* header)
+{
+    const CheckpointChunk* chunks = (const CheckpointChunk*)GetBlock(base, header, CHECKPOINT_CHUNK_SLOTS);
+    const unsigned char* chunkData = (const unsigned char*)GetBlock(base, header, CHECKPOINT_CHUNK_DATA);
+
+    grid->tick = header->tick;
+    memcpy(grid->sectionCounts, GetBlock(base, header, CHECKPOINT_SECTION_COUNTS), header->blocks[CHECKPOINT_SECTION_COUNTS].size);
+    memcpy(grid->cellCounts, header->cellCounts, sizeof(grid->cellCounts));
+
+    for (unsigned int chunkIndex = 0; chunkIndex < grid->chunkRows * grid->chunkCols; chunkIndex++)
+    {
+        const CheckpointChunk* record = &chunks[chunkIndex];
+        ChunkSlot* slot = &grid->chunks[chunkIndex];
+        if (record->kind == CHECKPOINT_CHUNK_LIVE)
+        {
+            CellChunk* chunk = slot->live ? slot->live : MakeChunkLive(grid, chunkIndex);
+            memcpy(chunk->cells, chunkData + record->offset, CHUNK_CELLS * sizeof(Cell));
+            memset(chunk->counts, 0, sizeof(chunk->counts));
+            for (unsigned int offset = 0; offset < CHUNK_CELLS; offset++)
+            {
+                chunk->counts[chunk->cells[offset].state]++;
+            }
+            chunk->lastChange = record->lastChange;
+        }
+        else if (record->kind == CHECKPOINT_CHUNK_PACKED)
+        {
+            slot->packed = (unsigned char*)malloc(CHUNK_CELLS / 4);
+            if (!slot->packed)
+            {
+                fprintf(stderr, "Memory allocation failed for packed chunk\n");
+                exit(1);
+            }
+            memcpy(slot->packed, chunkData + record->offset, CHUNK_CELLS / 4);
+            grid->packedCount++;
+        }
+        else
+        {
+            slot->uniform = record->uniform;
+        }
+    }
+
+    // The listed flags are exactly the cells in the burning list
+    FireFront* front = &grid->front;
+    RestoreCellList(&front->burning, (const uint64_t*)GetBlock(base, header, CHECKPOINT_BURNING),
+                    header->blocks[CHECKPOINT_BURNING].size / sizeof(uint64_t));
+    for (unsigned int entry = 0; entry < front->burning.count; entry++)
+    {
+        unsigned int row = front->burning.cells[entry] / grid->cols;
+        unsigned int col = front->burning.cells[entry] % grid->cols;
+        CellChunk* chunk = grid->chunks[GetChunkIndex(grid, row, col)].live;
+        chunk->listed[GetChunkOffset(row, col)] = 1;
+        chunk->listedCount++;
+    }
+
+    const uint32_t* wheelCounts = (const uint32_t*)GetBlock(base, header, CHECKPOINT_WHEEL_COUNTS);
+    const uint64_t* wheel = (const uint64_t*)GetBlock(base, header, CHECKPOINT_WHEEL);
+    for (unsigned int slot = 0; slot < BURNOUT_WHEEL_SIZE; slot++)
+    {
+        RestoreCellList(&front->wheel[slot], wheel, wheelCounts[slot]);
+        wheel += wheelCounts[slot];
+    }
+
+    if (grid->engine == FIRE_ENGINE_BITSLICED)
+    {
+        uint64_t planeBytes = GetPlaneWords(grid) * sizeof(uint64_t);
+        const unsigned char* planes = (const unsigned char*)GetBlock(base, header, CHECKPOINT_PLANES);
+        memcpy(grid->planes.burning, planes, planeBytes);
+        memcpy(grid->planes.unburnt, planes + planeBytes, planeBytes);
+        for (unsigned int slot = 0; slot < BURNOUT_WHEEL_SIZE; slot++)
+        {
+            memcpy(grid->planes.burnout[slot], planes + (2 + slot) * planeBytes, planeBytes);
+        }
+    }
+}
+
+// The file is mapped read-only and ValidateCheckpoint checks the whole mapping once, up front; RestoreGrid
+// then memcpy's every block into the simulation without checking again, so the file must not change while
+// it loads
+bool LoadCheckpoint(Simulation* sim, const char* path)
+{
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0)
+    {
+        fprintf(stderr, "Could not open checkpoint %s\n", path);
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size < (off_t)sizeof(CheckpointHeader))
+    {
+        fprintf(stderr, "Checkpoint %s is too short\n", path);
+        close(descriptor);
+        return false;
+    }
+
+    uint64_t fileSize = (uint64_t)status.st_size;
+    const unsigned char* base = (const unsigned char*)mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (base == MAP_FAILED)
+    {
+        fprintf(stderr, "Could not map checkpoint %s\n", path);
+        return false;
+    }
+
+    if (!ValidateCheckpoint(base, fileSize))
+    {
+        fprintf(stderr, "Checkpoint %s is damaged or from another version\n", path);
+        munmap((void*)base, fileSize);
+        return false;
+    }
+
+    const CheckpointHeader* header = (const CheckpointHeader*)base;
+    InitializeSimulation(sim, header->seed, (FireEngine)header->engine, header->cols, header->rows);
+
+    sim->frame = header->frame;
+    sim->minBoids = header->minBoids;
+    sim->maxBoids = header->maxBoids;
+    sim->updateFrequency = header->updateFrequency;
+    sim->iterationCounter = header->iterationCounter;
+    sim->spreadProbability = header->spreadProbability;
+    sim->totalBurning = header->totalBurning;
+    sim->spawnFactor = header->spawnFactor;
+    sim->maxForceTarget = header->maxForceTarget;
+    sim->grid.ignitionProbability = header->ignitionProbability;
+    sim->grid.fireIntensityBias = header->fireIntensityBias;
+    for (unsigned int target = 0; target < NUM_HOME_TARGETS; target++)
+    {
+        sim->homeTargets[target].x = header->homeTargets[target][0];
+        sim->homeTargets[target].y = header->homeTargets[target][1];
+    }
+    for (unsigned int subsystem = 0; subsystem < RNG_STREAM_COUNT; subsystem++)
+    {
+        GetRngStream(subsystem)->counter = header->rngCounters[subsystem];
+    }
+
+    Swarm* swarm = &sim->swarm;
+    ReserveSwarm(swarm, sim->maxBoids + NUM_HOME_TARGETS);
+    swarm->count = header->boidCount;
+    float* arrays[CHECKPOINT_ENERGY + 1] = {swarm->posx, swarm->posy, swarm->velx, swarm->vely, swarm->energy};
+    for (unsigned int block = CHECKPOINT_POSX; block <= CHECKPOINT_ENERGY; block++)
+    {
+        memcpy(arrays[block], GetBlock(base, header, block), header->blocks[block].size);
+    }
+    memcpy(swarm->flags, GetBlock(base, header, CHECKPOINT_FLAGS), header->blocks[CHECKPOINT_FLAGS].size);
+
+    RestoreGrid(&sim->grid, base, header);
+
+    munmap((void*)base, fileSize);
+    return true;
+}
@@ -0,0 +1,98 @@
+/******************************************************
+ * File:           checkpoint.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Binary snapshots of a whole simulation, loaded through mmap
+ ******************************************************/
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "simulation.h"
+#include "rng.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CHECKPOINT_MAGIC "BOIDCKPT"
+#define CHECKPOINT_VERSION 2
+#define CHECKPOINT_ALIGNMENT 64    // Every block starts on a cache line, loading copies each one out with a single memcpy
+#define CHECKPOINT_BYTE_ORDER 0x01020304u
+
+// Blocks of the file after the header, each an array in the layout the simulation keeps it in memory
+typedef enum {
+    CHECKPOINT_POSX,
+    CHECKPOINT_POSY,
+    CHECKPOINT_VELX,
+    CHECKPOINT_VELY,
+    CHECKPOINT_ENERGY,
+    CHECKPOINT_FLAGS,
+    CHECKPOINT_SECTION_COUNTS,     // Grid.sectionCounts
+    CHECKPOINT_CHUNK_SLOTS,        // One CheckpointChunk per chunk slot, row-major
+    CHECKPOINT_CHUNK_DATA,         // Cells of live chunks and 2-bit states of packed chunks
+    CHECKPOINT_BURNING,            // Sparse engine burning list, flat cell indices
+    CHECKPOINT_WHEEL_COUNTS,       // Sparse engine entries in each burnout wheel slot
+    CHECKPOINT_WHEEL,              // Sparse engine wheel entries, slot after slot
+    CHECKPOINT_PLANES,             // Bit-sliced engine burning, unburnt, then each burnout plane
+    CHECKPOINT_BLOCK_COUNT
+} CheckpointBlock;
+
+typedef enum {
+    CHECKPOINT_CHUNK_UNIFORM,
+    CHECKPOINT_CHUNK_PACKED,       // CHUNK_CELLS / 4 bytes of chunk data
+    CHECKPOINT_CHUNK_LIVE          // CHUNK_CELLS cells of chunk data
+} CheckpointChunkKind;
+
+typedef struct {
+    uint64_t offset;               // From the start of the file, a multiple of CHECKPOINT_ALIGNMENT
+    uint64_t size;                 // Bytes
+} CheckpointRange;
+
+typedef struct {
+    uint8_t kind;                  // CheckpointChunkKind
+    uint8_t uniform;               // State of every cell of a uniform chunk
+    uint16_t reserved;
+    uint32_t lastChange;
+    uint64_t offset;               // Into CHECKPOINT_CHUNK_DATA
+} CheckpointChunk;
+
+// Fixed-size header, everything a step reads that is not rebuilt by the next step
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;            // CHECKPOINT_BYTE_ORDER as written, files do not move across endianness
+    uint64_t headerSize;           // sizeof(CheckpointHeader), catches layout changes between builds
+    uint64_t fileSize;
+    uint64_t seed;
+    uint64_t frame;
+    uint64_t rngCounters[RNG_STREAM_COUNT];  // Main thread streams, the only ones with state between steps
+    uint32_t engine;
+    uint32_t cols;
+    uint32_t rows;
+    uint32_t numSectionsX;
+    uint32_t numSectionsY;
+    uint32_t tick;
+    uint32_t boidCount;
+    uint32_t minBoids;
+    uint32_t maxBoids;
+    uint32_t updateFrequency;
+    uint32_t iterationCounter;
+    float spreadProbability;
+    float totalBurning;
+    float spawnFactor;
+    float maxForceTarget;
+    float ignitionProbability;
+    float fireIntensityBias;
+    int32_t homeTargets[NUM_HOME_TARGETS][2];
+    uint64_t cellCounts[CELL_STATE_COUNT];
+    CheckpointRange blocks[CHECKPOINT_BLOCK_COUNT];
+} CheckpointHeader;
+
+// Both report failures on stderr and return false. A failed load leaves sim untouched.
+// Loading restores the random streams too; reseed with SeedRandom afterwards to fork the run.
+bool SaveCheckpoint(const Simulation* sim, const char* path);
+bool LoadCheckpoint(Simulation* sim, const char* path);
+
+#endif // CHECKPOINT_H
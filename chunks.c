@@ -0,0 +1,178 @@
+/******************************************************
+ * File:           chunks.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Chunked cell storage, allocated where fire has been
+ ******************************************************/
+
+#include "environment.h"
+#include <stdio.h>
+#include <string.h>
+
+void InitializeChunks(Grid* grid) {
+    grid->chunkRows = (grid->rows + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    grid->chunkCols = (grid->cols + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    grid->chunks = (ChunkSlot*)calloc((size_t)grid->chunkRows * grid->chunkCols, sizeof(ChunkSlot));  // Uniformly unburnt
+    if (!grid->chunks) {
+        fprintf(stderr, "Memory allocation failed for chunk directory\n");
+        exit(1);
+    }
+    grid->liveChunks = NULL;
+    grid->liveCount = 0;
+    grid->liveCapacity = 0;
+    grid->packedCount = 0;
+}
+
+static CellChunk* AllocateChunk(const Grid* grid) {
+    CellChunk* chunk = (CellChunk*)calloc(1, sizeof(CellChunk));
+    if (chunk) {
+        chunk->cells = (Cell*)malloc(CHUNK_CELLS * sizeof(Cell));
+        chunk->claims = (unsigned int*)malloc(CHUNK_CELLS * sizeof(unsigned int));
+        chunk->listed = (unsigned char*)calloc(CHUNK_CELLS, sizeof(unsigned char));
+        if (grid->engine == FIRE_ENGINE_DENSE) {
+            chunk->nextCells = (Cell*)calloc(CHUNK_CELLS, sizeof(Cell));
+        }
+    }
+    if (!chunk || !chunk->cells || !chunk->claims || !chunk->listed ||
+        (grid->engine == FIRE_ENGINE_DENSE && !chunk->nextCells)) {
+        fprintf(stderr, "Memory allocation failed for cell chunk\n");
+        exit(1);
+    }
+    memset(chunk->claims, 0xFF, CHUNK_CELLS * sizeof(unsigned int));  // CELL_UNCLAIMED
+    return chunk;
+}
+
+static void FreeChunk(CellChunk* chunk) {
+    free(chunk->cells);
+    free(chunk->nextCells);
+    free(chunk->claims);
+    free(chunk->listed);
+    free(chunk);
+}
+
+// Gives a packed or uniform chunk full storage. Only called between steps or from the serial parts of
+// a step, since it can move the live list.
+CellChunk* MakeChunkLive(Grid* grid, unsigned int chunkIndex) {
+    ChunkSlot* slot = &grid->chunks[chunkIndex];
+    CellChunk* chunk = AllocateChunk(grid);
+
+    if (slot->packed) {
+        for (unsigned int offset = 0; offset < CHUNK_CELLS; ++offset) {
+            unsigned char state = (slot->packed[offset / 4] >> ((offset % 4) * 2)) & 3;
+            chunk->cells[offset] = (Cell){state, 0};
+            chunk->counts[state]++;
+        }
+        free(slot->packed);
+        slot->packed = NULL;
+        grid->packedCount--;
+    } else {
+        for (unsigned int offset = 0; offset < CHUNK_CELLS; ++offset) {
+            chunk->cells[offset] = (Cell){slot->uniform, 0};
+        }
+        chunk->counts[slot->uniform] = CHUNK_CELLS;
+    }
+    chunk->lastChange = grid->tick;
+
+    if (grid->liveCount == grid->liveCapacity) {
+        unsigned int newCapacity = grid->liveCapacity ? grid->liveCapacity * 2 : 16;
+        unsigned int* liveChunks = (unsigned int*)realloc(grid->liveChunks, newCapacity * sizeof(unsigned int));
+        if (!liveChunks) {
+            fprintf(stderr, "Memory allocation failed for live chunk list\n");
+            exit(1);
+        }
+        grid->liveChunks = liveChunks;
+        grid->liveCapacity = newCapacity;
+    }
+    chunk->livePosition = grid->liveCount;
+    grid->liveChunks[grid->liveCount++] = chunkIndex;
+
+    slot->live = chunk;
+    return chunk;
+}
+
+// Chunks without fire that have not changed for CHUNK_IDLE_TICKS drop to 2 bits per cell, or to nothing
+// when every cell is in the same state. Timers, claims and burning-list flags are only meaningful for
+// burning cells, so the state is all that needs keeping. The dense engine keeps every chunk live.
+void PackIdleChunks(Grid* grid) {
+    if (grid->engine == FIRE_ENGINE_DENSE) {
+        return;
+    }
+
+    for (unsigned int position = grid->liveCount; position-- > 0;) {
+        unsigned int chunkIndex = grid->liveChunks[position];
+        ChunkSlot* slot = &grid->chunks[chunkIndex];
+        CellChunk* chunk = slot->live;
+        if (chunk->counts[1] > 0 || chunk->listedCount > 0 || grid->tick - chunk->lastChange < CHUNK_IDLE_TICKS) {
+            continue;
+        }
+
+        slot->uniform = CELL_STATE_COUNT;
+        for (unsigned char state = 0; state < CELL_STATE_COUNT; ++state) {
+            if (chunk->counts[state] == CHUNK_CELLS) {
+                slot->uniform = state;
+            }
+        }
+
+        if (slot->uniform == CELL_STATE_COUNT) {
+            slot->uniform = 0;
+            slot->packed = (unsigned char*)calloc(CHUNK_CELLS / 4, sizeof(unsigned char));
+            if (!slot->packed) {
+                fprintf(stderr, "Memory allocation failed for packed chunk\n");
+                exit(1);
+            }
+            for (unsigned int offset = 0; offset < CHUNK_CELLS; ++offset) {
+                slot->packed[offset / 4] |= chunk->cells[offset].state << ((offset % 4) * 2);
+            }
+            grid->packedCount++;
+        }
+
+        // Swap-remove, the chunk moved into this position has already been looked at
+        unsigned int last = grid->liveChunks[--grid->liveCount];
+        grid->liveChunks[position] = last;
+        grid->chunks[last].live->livePosition = position;
+
+        slot->live = NULL;
+        FreeChunk(chunk);
+    }
+}
+
+// Cell storage and dirty rows only, for threads that draw a grid without stepping it. Cells are written
+// straight through GetCell, the chunk counters are not kept and chunks are never packed.
+void InitializeViewGrid(Grid* grid, unsigned int cols, unsigned int rows) {
+    *grid = (Grid){0};
+    grid->cols = cols;
+    grid->rows = rows;
+    grid->engine = FIRE_ENGINE_SPARSE;  // No second cell buffer per chunk
+    InitializeChunks(grid);
+    grid->dirtyRows = (unsigned char*)malloc(rows);
+    if (!grid->dirtyRows) {
+        fprintf(stderr, "Memory allocation failed for dirty rows\n");
+        exit(1);
+    }
+    memset(grid->dirtyRows, DIRTY_ROW_ALL, rows);
+}
+
+void FreeViewGrid(Grid* grid) {
+    FreeChunks(grid);
+    free(grid->dirtyRows);
+    grid->dirtyRows = NULL;
+}
+
+void FreeChunks(Grid* grid) {
+    for (unsigned int chunkIndex = 0; chunkIndex < grid->chunkRows * grid->chunkCols; ++chunkIndex) {
+        if (grid->chunks[chunkIndex].live) {
+            FreeChunk(grid->chunks[chunkIndex].live);
+        }
+        free(grid->chunks[chunkIndex].packed);
+    }
+    free(grid->chunks);
+    free(grid->liveChunks);
+    grid->chunks = NULL;
+    grid->liveChunks = NULL;
+    grid->liveCount = 0;
+    grid->liveCapacity = 0;
+    grid->packedCount = 0;
+}
@@ -3,7 +3,7 @@
  * Project:        Boid Swarm Firefight
  * Author:         Peter Ryseck
  * Date Created:   February 8, 2025
- * Last Updated:   February 8, 2025
+ * Last Updated:   October 16, 2026
  *
  * Description:    Macro constants used throughout boid-firefight
  ******************************************************/
@@ -17,12 +17,14 @@
 #define SCREEN_HEIGHT 1020
 #define GRID_WIDTH (SCREEN_WIDTH / CELL_SIZE)
 #define GRID_HEIGHT (SCREEN_HEIGHT / CELL_SIZE)
-#define CAP_FRAME_TIME 33 // 33 ms is 30 fps, set to 0 to avoid capping frame rate
+#define CAP_FRAME_TIME 33 // Replay frame cap, 33 ms is 30 fps, set to 0 to run at the display's refresh rate
+#define SIM_STEP_RATE 120 // Viewer simulation steps per second, on a thread of its own while frames follow vsync
 
 // Boid behavior
 #define SEPARATION_RADIUS 5.0f
 #define ALIGNMENT_RADIUS 17.0f
 #define COHESION_RADIUS 17.0f
+#define NEIGHBOR_CELL_SIZE 17.0f // Spatial hash bucket size, at least max(ALIGNMENT_RADIUS, COHESION_RADIUS)
 #define MAX_SEPERATION_FORCE 0.2f
 #define MAX_ALIGNMENT_FORCE 0.05f
 #define MAX_COHESION_FORCE 0.05f
@@ -40,8 +42,14 @@
 #define MIN_BOID_NUM 100
 #define MAX_BOID_NUM 1000
 #define MAX_FORCE_INTENSITY_DISTRIBUTION 0.3
+#define NUM_SECTIONS_X 5 // Distribution sections across the map, fewer on worlds narrower than this in cells
+#define NUM_SECTIONS_Y 5 // Distribution sections down the map, fewer on worlds shorter than this in cells
+
+// Threading
+#define NUM_THREADS 0 // Threads for the boid update including the main thread, 0 uses every online core
 
 // Environment behavior
+#define FIRE_ENGINE FIRE_ENGINE_SPARSE // FIRE_ENGINE_SPARSE only visits the fire front, FIRE_ENGINE_BITSLICED packs 64 cells per word, FIRE_ENGINE_DENSE visits every cell
 #define MIN_SPREAD_PROBABILITY 0.02f
 #define MAX_SPREAD_PROBABILITY 0.06f
 #define MAX_SPREAD_FREQ_COUNT 900
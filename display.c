@@ -3,7 +3,7 @@
  * Project:        Boid Swarm Firefight
  * Author:         Peter Ryseck
  * Date Created:   February 8, 2025
- * Last Updated:   February 8, 2025
+ * Last Updated:   October 16, 2026
  *
  * Description:    Display and rendering operations
  ******************************************************/
@@ -13,6 +13,7 @@
 #include "environment.h"
 #include "utils.h"
 #include "constants.h"
+#include "profile.h"
 #include <stdio.h>
 
 void InitDisplay(SDL_Window **window, SDL_Renderer **renderer) {
@@ -36,7 +37,7 @@ void InitDisplay(SDL_Window **window, SDL_Renderer **renderer) {
         exit(1);
     }
 
-    *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_ACCELERATED);
+    *renderer = SDL_CreateRenderer(*window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
     if (!*renderer) {
         printf("Renderer could not be created! SDL_Error: %s\n", SDL_GetError());
         SDL_DestroyWindow(*window);
@@ -45,134 +46,371 @@ void InitDisplay(SDL_Window **window, SDL_Renderer **renderer) {
     }
 }
 
-void RenderHomeTargets(SDL_Renderer *renderer, HomeTarget *homeTargets, unsigned int numTargets) {
-    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255); // Set the color to green
-    
+// The home circle is rasterized once into a texture, each target is then a single copy
+SDL_Texture* CreateHomeTargetSprite(SDL_Renderer *renderer) {
+    int size = HOME_TARGET_RADIUS * 2;
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!surface) {
+        printf("Home target sprite could not be created! SDL_Error: %s\n", SDL_GetError());
+        exit(1);
+    }
+
+    // Texel (w, h) sits at dx = w - radius + 1 from the center, matching the old point-by-point circle
+    for (int h = 0; h < size; ++h) {
+        Uint32 *texels = (Uint32 *)((Uint8 *)surface->pixels + h * surface->pitch);
+        for (int w = 0; w < size; ++w) {
+            int dx = w - HOME_TARGET_RADIUS + 1;
+            int dy = h - HOME_TARGET_RADIUS + 1;
+            bool inside = (dx * dx + dy * dy) <= (HOME_TARGET_RADIUS * HOME_TARGET_RADIUS);
+            texels[w] = inside ? 0xFF00FF00 : 0x00000000; // Green, transparent outside the circle
+        }
+    }
+
+    SDL_Texture *sprite = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_FreeSurface(surface);
+    if (!sprite) {
+        printf("Home target sprite could not be created! SDL_Error: %s\n", SDL_GetError());
+        exit(1);
+    }
+    SDL_SetTextureBlendMode(sprite, SDL_BLENDMODE_BLEND);
+    return sprite;
+}
+
+void RenderHomeTargets(SDL_Renderer *renderer, SDL_Texture *sprite, HomeTarget *homeTargets, unsigned int numTargets) {
+    PROFILE_BEGIN(PROFILE_RENDER_TARGETS);
     for (unsigned int index = 0; index < numTargets; ++index) {
-        int centerX = (int)homeTargets[index].x;
-        int centerY = (int)homeTargets[index].y;
-        int radius = 10;
-
-        // Draw the circle
-        for (int w = 0; w < radius * 2; ++w) {
-            for (int h = 0; h < radius * 2; ++h) {
-                int dx = radius - w; // Horizontal distance from center
-                int dy = radius - h; // Vertical distance from center
-                if ((dx * dx + dy * dy) <= (radius * radius)) {
-                    SDL_RenderDrawPoint(renderer, centerX + dx, centerY + dy);
+        SDL_Rect rect = {
+            .x = (int)homeTargets[index].x - HOME_TARGET_RADIUS + 1,
+            .y = (int)homeTargets[index].y - HOME_TARGET_RADIUS + 1,
+            .w = HOME_TARGET_RADIUS * 2,
+            .h = HOME_TARGET_RADIUS * 2
+        };
+        SDL_RenderCopy(renderer, sprite, NULL, &rect);
+    }
+    PROFILE_END(PROFILE_RENDER_TARGETS);
+}
+
+// ARGB colors of the cell states
+static const Uint32 cellColors[4] = {
+    0xFFFFFFFF, // Not burnt, white
+    0xFFFF0000, // Burning, red
+    0xFF000000, // Burnt, black
+    0xFF0064FF  // Extinguished, light blue
+};
+
+// One texel per cell, scaled up to CELL_SIZE when it is copied to the screen
+SDL_Texture* CreateGridTexture(SDL_Renderer *renderer, const Grid *grid) {
+    SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                                             grid->cols, grid->rows);
+    if (!texture) {
+        printf("Grid texture could not be created! SDL_Error: %s\n", SDL_GetError());
+        exit(1);
+    }
+    return texture;
+}
+
+// Uploads only the rows that changed since the last call, each run of dirty rows is one locked rectangle
+void RenderGrid(SDL_Renderer *renderer, SDL_Texture *texture, Grid *grid) {
+    PROFILE_BEGIN(PROFILE_RENDER_GRID);
+    unsigned int rowIndex = 0;
+    while (rowIndex < grid->rows) {
+        if (!(grid->dirtyRows[rowIndex] & DIRTY_ROW_RENDER)) {
+            rowIndex++;
+            continue;
+        }
+
+        unsigned int endRow = rowIndex;
+        while (endRow < grid->rows && (grid->dirtyRows[endRow] & DIRTY_ROW_RENDER)) {
+            grid->dirtyRows[endRow++] &= ~DIRTY_ROW_RENDER;
+        }
+
+        SDL_Rect rect = {0, (int)rowIndex, (int)grid->cols, (int)(endRow - rowIndex)};
+        void *pixels;
+        int pitch;
+        if (SDL_LockTexture(texture, &rect, &pixels, &pitch) == 0) {
+            for (unsigned int row = rowIndex; row < endRow; ++row) {
+                Uint32 *texels = (Uint32 *)((Uint8 *)pixels + (row - rowIndex) * pitch);
+                for (unsigned int colIndex = 0; colIndex < grid->cols; ++colIndex) {
+                    texels[colIndex] = cellColors[GetCellState(grid, row, colIndex)];
                 }
             }
+            SDL_UnlockTexture(texture);
         }
+        rowIndex = endRow;
     }
+
+    SDL_Rect destination = {0, 0, (int)(grid->cols * CELL_SIZE), (int)(grid->rows * CELL_SIZE)};
+    SDL_RenderCopy(renderer, texture, NULL, &destination);
+    PROFILE_END(PROFILE_RENDER_GRID);
 }
 
-void RenderGrid(SDL_Renderer *renderer, Grid *grid) {
-    for (unsigned int rowIndex = 0; rowIndex < grid->rows; ++rowIndex) {
-        for (unsigned int colIndex = 0; colIndex < grid->cols; ++colIndex) {
-            Cell *cell = &grid->cells[rowIndex][colIndex];
-            SDL_Color color;
-
-            switch (cell->state) {
-                case 0: // Not burnt
-                    color = (SDL_Color){255, 255, 255, 255}; // White
-                    break;
-                case 1: // Burning
-                    color = (SDL_Color){255, 0, 0, 255}; // Red
-                    break;
-                case 2: // Burnt
-                    color = (SDL_Color){0, 0, 0, 255}; // Black
-                    break;
-                case 3: // Extinguished
-                    color = (SDL_Color){0, 100, 255, 255}; // Light Blue
-                    break;
-                default:
-                    color = (SDL_Color){255, 255, 255, 255}; // Default to white
-                    break;
-            }
+// Cosine and sine of the arrowhead half-angle, which narrows as the boid speeds up
+static float arrowheadTurn[ARROWHEAD_STEPS][2];
 
-            SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+static void InitializeArrowheadTurns(void) {
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    for (unsigned int step = 0; step < ARROWHEAD_STEPS; ++step) {
+        float mag = step * ARROWHEAD_MAX_MAG / (ARROWHEAD_STEPS - 1);
+        float halfAngle = (M_PI / 6) * 1.25f * (1 - mag * .08f);
+        arrowheadTurn[step][0] = cosf(halfAngle);
+        arrowheadTurn[step][1] = sinf(halfAngle);
+    }
+    initialized = true;
+}
 
-            // Draw the cell as a filled rectangle
-            SDL_Rect rect = {
-                .x = colIndex * CELL_SIZE,
-                .y = rowIndex * CELL_SIZE,
-                .w = CELL_SIZE,
-                .h = CELL_SIZE
-            };
-            SDL_RenderFillRect(renderer, &rect);
-        }
+static void GrowBoidMesh(BoidMesh *mesh, unsigned int count) {
+    if (count <= mesh->capacity) {
+        return;
     }
+    unsigned int capacity = mesh->capacity ? mesh->capacity : 1024;
+    while (capacity < count) {
+        capacity *= 2;
+    }
+
+    SDL_Vertex *vertices = (SDL_Vertex *)realloc(mesh->vertices, (size_t)capacity * ARROW_VERTICES * sizeof(SDL_Vertex));
+    int *indices = (int *)realloc(mesh->indices, (size_t)capacity * ARROW_INDICES * sizeof(int));
+    if (!vertices || !indices) {
+        fprintf(stderr, "Memory allocation failed for boid mesh\n");
+        exit(1);
+    }
+    mesh->vertices = vertices;
+    mesh->indices = indices;
+    mesh->capacity = capacity;
 }
 
-void DrawArrow(SDL_Renderer *renderer, float centerX, float centerY, float angle, float length, float mag) {
-    // Arrow's line coordinates
-    float lineEndX = centerX - length * cos(angle);
-    float lineEndY = centerY - length * sin(angle);
+typedef struct {
+    BoidMesh *mesh;
+    const Swarm *swarm;
+} ArrowTask;
+
+// Writes the arrows of boids [begin, end) into their own slots of the mesh. Each arrow is a
+// one pixel wide shaft running 1.3 lengths ahead of the boid and a filled head at one length.
+static void BuildArrows(void *context, unsigned int begin, unsigned int end, unsigned int thread) {
+    (void)thread;
+    ArrowTask *task = (ArrowTask *)context;
+    const Swarm *swarm = task->swarm;
+    const float length = 10.0f;
+    const float arrowheadSize = 7.0f;
+
+    for (unsigned int index = begin; index < end; ++index) {
+        SDL_Color color;
+        if ((swarm->flags[index] & BOID_HEADING_HOME) && !(swarm->flags[index] & BOID_TO_BE_REMOVED)) {
+            color = (SDL_Color){255, 180, 100, 180};  // Soft light blue
+        } else {
+            color = (SDL_Color){50, 50, 200, 255};  // Normal blue
+        }
 
-    // Arrow's line coordinates
-    float lineEndXn = centerX - (length-7) * cos(angle);
-    float lineEndYn = centerY - (length-7) * sin(angle);
+        // Unit heading from the velocity, no trigonometry needed
+        float mag;
+        Magnitude(swarm->velx[index], swarm->vely[index], &mag);
+        float dirX = (mag > 0) ? swarm->velx[index] / mag : 1.0f;
+        float dirY = (mag > 0) ? swarm->vely[index] / mag : 0.0f;
 
-    // Draw the line for the arrow
-    SDL_RenderDrawLine(renderer, (int)centerX, (int)centerY, (int)lineEndX, (int)lineEndY);
+        unsigned int step = (unsigned int)(mag * (ARROWHEAD_STEPS - 1) / ARROWHEAD_MAX_MAG);
+        if (step >= ARROWHEAD_STEPS) {
+            step = ARROWHEAD_STEPS - 1;
+        }
+        float turnCos = arrowheadTurn[step][0];
+        float turnSin = arrowheadTurn[step][1];
+
+        float centerX = swarm->posx[index];
+        float centerY = swarm->posy[index];
+        float tipX = centerX + length * dirX;
+        float tipY = centerY + length * dirY;
+        float noseX = centerX + length * 1.3f * dirX;
+        float noseY = centerY + length * 1.3f * dirY;
+
+        // Head corners, the backward heading turned each way by the half-angle
+        float head1X = tipX - arrowheadSize * (dirX * turnCos + dirY * turnSin);
+        float head1Y = tipY - arrowheadSize * (dirY * turnCos - dirX * turnSin);
+        float head2X = tipX - arrowheadSize * (dirX * turnCos - dirY * turnSin);
+        float head2Y = tipY - arrowheadSize * (dirY * turnCos + dirX * turnSin);
+
+        float sideX = -dirY * 0.5f;
+        float sideY = dirX * 0.5f;
+
+        SDL_Vertex *vertex = &task->mesh->vertices[index * ARROW_VERTICES];
+        vertex[0] = (SDL_Vertex){{centerX + sideX, centerY + sideY}, color, {0, 0}};
+        vertex[1] = (SDL_Vertex){{centerX - sideX, centerY - sideY}, color, {0, 0}};
+        vertex[2] = (SDL_Vertex){{noseX + sideX, noseY + sideY}, color, {0, 0}};
+        vertex[3] = (SDL_Vertex){{noseX - sideX, noseY - sideY}, color, {0, 0}};
+        vertex[4] = (SDL_Vertex){{tipX, tipY}, color, {0, 0}};
+        vertex[5] = (SDL_Vertex){{head1X, head1Y}, color, {0, 0}};
+        vertex[6] = (SDL_Vertex){{head2X, head2Y}, color, {0, 0}};
+
+        int base = (int)(index * ARROW_VERTICES);
+        int *indices = &task->mesh->indices[index * ARROW_INDICES];
+        indices[0] = base + 0; indices[1] = base + 1; indices[2] = base + 2;  // Shaft
+        indices[3] = base + 1; indices[4] = base + 3; indices[5] = base + 2;
+        indices[6] = base + 4; indices[7] = base + 5; indices[8] = base + 6;  // Head
+    }
+}
 
-    // Arrow's line coordinates
-    float lineEndX2 = centerX - length*1.3 * cos(angle);
-    float lineEndY2 = centerY - length*1.3 * sin(angle);
+// Builds one vertex buffer for the whole swarm on the pool and submits it in a single draw call
+void RenderBoids(SDL_Renderer *renderer, BoidMesh *mesh, const Swarm *swarm, ThreadPool *pool) {
+    PROFILE_BEGIN(PROFILE_RENDER_BOIDS);
+    InitializeArrowheadTurns();
+    GrowBoidMesh(mesh, swarm->count);
 
-    // Draw the line for the arrow
-    SDL_RenderDrawLine(renderer, (int)centerX, (int)centerY, (int)lineEndX2, (int)lineEndY2);
+    ArrowTask task = {mesh, swarm};
+    RunParallel(pool, swarm->count, ARROW_TASK_GRAIN, BuildArrows, &task);
 
-    // Arrowhead size
-    float arrowheadSize = 7.0f;
+    if (swarm->count > 0) {
+        SDL_RenderGeometry(renderer, NULL, mesh->vertices, (int)(swarm->count * ARROW_VERTICES),
+                           mesh->indices, (int)(swarm->count * ARROW_INDICES));
+    }
+    PROFILE_END(PROFILE_RENDER_BOIDS);
+}
 
-    // Angle for the arrowhead
-    float arrowheadAngle1 = angle - (M_PI / 6)*1.25*(1-mag*.08);
-    float arrowheadAngle2 = angle + (M_PI / 6)*1.25*(1-mag*.08);
+// Present the rendered frame, overlays are drawn before this
+void PresentFrame(SDL_Renderer *renderer) {
+    PROFILE_BEGIN(PROFILE_PRESENT);
+    SDL_RenderPresent(renderer);
+    PROFILE_END(PROFILE_PRESENT);
+}
 
-    // Arrowhead points
-    float headX1 = lineEndX + arrowheadSize * cos(arrowheadAngle1);
-    float headY1 = lineEndY + arrowheadSize * sin(arrowheadAngle1);
+// 3x5 pixel glyphs, one octal digit per row from the top, the high bit is the left column
+static unsigned int GetOverlayGlyph(char character) {
+    static const unsigned short digits[10] = {
+        075557, 026227, 071747, 071717, 055711, 074717, 074757, 071111, 075757, 075717
+    };
+    static const unsigned short letters[26] = {
+        025755, 065656, 034443, 065556, 074647, 074644, 034553, 055755, 072227, 011152, 055655, 044447, 057755,
+        065555, 025552, 065644, 025563, 065655, 034216, 072222, 055557, 055552, 055775, 055255, 055222, 071247
+    };
+
+    if (character >= '0' && character <= '9') {
+        return digits[character - '0'];
+    }
+    if (character >= 'a' && character <= 'z') {
+        return letters[character - 'a'];
+    }
+    if (character >= 'A' && character <= 'Z') {
+        return letters[character - 'A'];
+    }
+    switch (character) {
+        case '.': return 000002;
+        case ':': return 002020;
+        case '/': return 011244;
+        case '-': return 000700;
+        case '_': return 000007;
+        default: return 0;
+    }
+}
 
-    float headX2 = lineEndX + arrowheadSize * cos(arrowheadAngle2);
-    float headY2 = lineEndY + arrowheadSize * sin(arrowheadAngle2);
+// One batched draw per string, in the current draw color
+static void DrawOverlayText(SDL_Renderer *renderer, int x, int y, const char *text) {
+    SDL_Rect pixels[OVERLAY_TEXT_MAX * 15];
+    int count = 0;
+    for (unsigned int index = 0; index < OVERLAY_TEXT_MAX && text[index]; ++index) {
+        unsigned int glyph = GetOverlayGlyph(text[index]);
+        for (unsigned int bit = 0; bit < 15; ++bit) {
+            if (glyph & (1u << (14 - bit))) {
+                pixels[count++] = (SDL_Rect){x + (int)(index * 4 + bit % 3) * OVERLAY_PIXEL,
+                                             y + (int)(bit / 3) * OVERLAY_PIXEL, OVERLAY_PIXEL, OVERLAY_PIXEL};
+            }
+        }
+    }
+    SDL_RenderFillRects(renderer, pixels, count);
+}
 
-    // Draw the arrowhead (two lines)
-    SDL_RenderDrawLine(renderer, (int)lineEndX, (int)lineEndY, (int)headX1, (int)headY1);
-    SDL_RenderDrawLine(renderer, (int)lineEndX, (int)lineEndY, (int)headX2, (int)headY2);
+// Rates shown by the overlay, refreshed every OVERLAY_SAMPLE_SECONDS so the numbers stay readable
+typedef struct {
+    ProfileTotals last;
+    double lastTime;
+    double zoneMilliseconds[PROFILE_ZONE_COUNT];   // Per step, render zones per presented frame
+    double counterPerStep[PROFILE_COUNTER_COUNT];
+    double stepsPerSecond;
+} OverlayRates;
+
+static OverlayRates overlayRates;
+
+static void UpdateOverlayRates(void) {
+    double now = GetTimeSeconds();
+    if (now - overlayRates.lastTime < OVERLAY_SAMPLE_SECONDS) {
+        return;
+    }
 
-    // Arrowhead point
-    float headX3 = lineEndXn + arrowheadSize*.5 * cos(arrowheadAngle1);
-    float headY3 = lineEndYn + arrowheadSize*.5 * sin(arrowheadAngle1);
+    ProfileTotals totals;
+    ReadProfileTotals(&totals);
+    const ProfileTotals *last = &overlayRates.last;
+    uint64_t steps = totals.calls[PROFILE_STEP] - last->calls[PROFILE_STEP];
 
-    float headX4 = lineEndXn + arrowheadSize*.5 * cos(arrowheadAngle2);
-    float headY4 = lineEndYn + arrowheadSize*.5 * sin(arrowheadAngle2);
+    for (unsigned int zone = 0; zone < PROFILE_ZONE_COUNT; ++zone) {
+        ProfileZone root = GetProfileZoneRoot(zone);
+        uint64_t calls = totals.calls[root] - last->calls[root];
+        uint64_t nanoseconds = totals.nanoseconds[zone] - last->nanoseconds[zone];
+        overlayRates.zoneMilliseconds[zone] = calls ? nanoseconds / 1e6 / calls : 0.0;
+    }
+    for (unsigned int counter = 0; counter < PROFILE_COUNTER_COUNT; ++counter) {
+        uint64_t amount = totals.counters[counter] - last->counters[counter];
+        overlayRates.counterPerStep[counter] = steps ? (double)amount / steps : 0.0;
+    }
+    overlayRates.stepsPerSecond = overlayRates.lastTime > 0 ? steps / (now - overlayRates.lastTime) : 0.0;
 
-    // Draw the arrowhead (two lines)
-    SDL_RenderDrawLine(renderer, (int)lineEndXn, (int)lineEndYn, (int)headX3, (int)headY3);
-    SDL_RenderDrawLine(renderer, (int)lineEndXn, (int)lineEndYn, (int)headX4, (int)headY4);
+    overlayRates.last = totals;
+    overlayRates.lastTime = now;
 }
 
-void RenderBoids(SDL_Renderer *renderer, Boid *boids, int numBoids) {
-
-    for (unsigned int index = 0; index < numBoids; ++index) {
-        // Check if the boid is heading home and set the color accordingly
-        if (boids[index].headingHome && !boids[index].headingHomeToBeRemoved) {
-            SDL_SetRenderDrawColor(renderer, 255, 180, 100, 180);  // Soft light blue
-        } else {
-            SDL_SetRenderDrawColor(renderer, 50, 50, 200, 255);  // Normal blue
-        }
+// Milliseconds per call of each zone as a bar and a number, then the work counters per step
+void RenderProfileOverlay(SDL_Renderer *renderer) {
+    int lineHeight = 7 * OVERLAY_PIXEL;
+    int x = OVERLAY_MARGIN;
+    int y = OVERLAY_MARGIN;
+    char text[OVERLAY_TEXT_MAX + 1];
+
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    if (!PROFILE_ENABLED) {
+        SDL_Rect background = {0, 0, 2 * OVERLAY_MARGIN + 25 * 4 * OVERLAY_PIXEL, 2 * OVERLAY_MARGIN + lineHeight};
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+        SDL_RenderFillRect(renderer, &background);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        DrawOverlayText(renderer, x, y, "build with -DBOID_PROFILE");
+        return;
+    }
 
-        float mag;
-        Magnitude(boids[index].velx, boids[index].vely, &mag);
+    UpdateOverlayRates();
+    int labelWidth = 16 * 4 * OVERLAY_PIXEL;
+    int lines = 1 + PROFILE_ZONE_COUNT + PROFILE_COUNTER_COUNT;
+    SDL_Rect background = {0, 0, 2 * OVERLAY_MARGIN + labelWidth + OVERLAY_BAR_WIDTH + 10 * 4 * OVERLAY_PIXEL,
+                           2 * OVERLAY_MARGIN + lines * lineHeight};
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 160);
+    SDL_RenderFillRect(renderer, &background);
+
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    snprintf(text, sizeof(text), "steps/s %.0f", overlayRates.stepsPerSecond);
+    DrawOverlayText(renderer, x, y, text);
+    y += lineHeight;
+
+    for (unsigned int zone = 0; zone < PROFILE_ZONE_COUNT; ++zone) {
+        double milliseconds = overlayRates.zoneMilliseconds[zone];
+        int barWidth = (int)(milliseconds * OVERLAY_BAR_WIDTH / OVERLAY_BAR_MILLISECONDS);
+        SDL_Rect bar = {x + labelWidth, y, barWidth < OVERLAY_BAR_WIDTH ? barWidth : OVERLAY_BAR_WIDTH, 5 * OVERLAY_PIXEL};
+
+        SDL_SetRenderDrawColor(renderer, 255, 160, 0, 255);
+        SDL_RenderFillRect(renderer, &bar);
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        DrawOverlayText(renderer, x, y, GetProfileZoneName(zone));
+        snprintf(text, sizeof(text), "%.2f ms", milliseconds);
+        DrawOverlayText(renderer, x + labelWidth + OVERLAY_BAR_WIDTH + 2 * OVERLAY_PIXEL, y, text);
+        y += lineHeight;
+    }
 
-        // Draw each boid as an arrow based on its position and velocity
-        float angle = atan2(boids[index].vely, boids[index].velx) + M_PI;
-        DrawArrow(renderer, boids[index].posx, boids[index].posy, angle, 10.0f, mag); // Adjust arrow length as needed
+    for (unsigned int counter = 0; counter < PROFILE_COUNTER_COUNT; ++counter) {
+        snprintf(text, sizeof(text), "%.0f", overlayRates.counterPerStep[counter]);
+        DrawOverlayText(renderer, x, y, GetProfileCounterName(counter));
+        DrawOverlayText(renderer, x + labelWidth, y, text);
+        y += lineHeight;
     }
+}
 
-    // Present the rendered frame
-    SDL_RenderPresent(renderer);  
+void FreeBoidMesh(BoidMesh *mesh) {
+    free(mesh->vertices);
+    free(mesh->indices);
+    *mesh = (BoidMesh){0};
 }
 
 void CleanupDisplay(SDL_Window *window, SDL_Renderer *renderer) {
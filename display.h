@@ -3,7 +3,7 @@
  * Project:        Boid Swarm Firefight
  * Author:         Peter Ryseck
  * Date Created:   February 8, 2025
- * Last Updated:   February 8, 2025
+ * Last Updated:   October 16, 2026
  *
  * Description:    Display and rendering operations
  ******************************************************/
@@ -14,11 +14,37 @@
 #include <SDL.h>
 #include "constants.h"
 #include "environment.h"
+#include "threadpool.h"
+
+#define HOME_TARGET_RADIUS 10      // Radius of the home target sprite in pixels
+#define ARROW_VERTICES 7           // Shaft quad and head triangle
+#define ARROW_INDICES 9            // Three triangles per arrow
+#define ARROWHEAD_STEPS 64         // Entries in the arrowhead angle table
+#define ARROWHEAD_MAX_MAG (2 * MAX_SPEED) // Speed covered by the table, faster boids use the last entry
+#define ARROW_TASK_GRAIN 1024      // Boids per pool task when building arrows
+#define OVERLAY_SAMPLE_SECONDS 0.5 // Profile overlay averaging window
+#define OVERLAY_PIXEL 2            // Screen pixels per overlay font pixel
+#define OVERLAY_MARGIN 8           // Pixels around the overlay text
+#define OVERLAY_TEXT_MAX 32        // Characters per overlay string
+#define OVERLAY_BAR_WIDTH 160      // Pixels of a full overlay bar
+#define OVERLAY_BAR_MILLISECONDS 8.0 // Time a full overlay bar stands for, longer zones are clipped
+
+// Vertex and index buffers for the boid arrows, reused from frame to frame
+typedef struct {
+    SDL_Vertex *vertices;
+    int *indices;
+    unsigned int capacity;     // Boids the buffers have room for
+} BoidMesh;
 
 void InitDisplay(SDL_Window **window, SDL_Renderer **renderer);
-void RenderBoids(SDL_Renderer *renderer, Boid *boids, int numBoids);
-void RenderGrid(SDL_Renderer *renderer, Grid *grid);
+void RenderBoids(SDL_Renderer *renderer, BoidMesh *mesh, const Swarm *swarm, ThreadPool *pool);
+void FreeBoidMesh(BoidMesh *mesh);
+SDL_Texture* CreateGridTexture(SDL_Renderer *renderer, const Grid *grid);
+void RenderGrid(SDL_Renderer *renderer, SDL_Texture *texture, Grid *grid);
 void CleanupDisplay(SDL_Window *window, SDL_Renderer *renderer);
-void RenderHomeTargets(SDL_Renderer *renderer, HomeTarget *homeTargets, unsigned int numTargets);
+SDL_Texture* CreateHomeTargetSprite(SDL_Renderer *renderer);
+void RenderHomeTargets(SDL_Renderer *renderer, SDL_Texture *sprite, HomeTarget *homeTargets, unsigned int numTargets);
+void RenderProfileOverlay(SDL_Renderer *renderer);
+void PresentFrame(SDL_Renderer *renderer);
 
 #endif // DISPLAY_H
@@ -0,0 +1,499 @@
+/******************************************************
+ * File:           ensemble.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Monte Carlo parameter sweeps over many seeded headless runs
+ * Compile: gcc -O3 -march=native -o boid-ensemble ensemble.c simulation.c boid.c utils.c environment.c bitfire.c spatial_hash.c kernels.c rng.c threadpool.c section_pyramid.c chunks.c checkpoint.c recorder.c profile.c -lm -lpthread -lz
+ * Usage:   ./boid-ensemble spec.txt [workers] > results.jsonl
+ ******************************************************/
+
+#include "simulation.h"
+#include "constants.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define ENSEMBLE_MAX_VALUES 64       // Values per swept parameter
+#define ENSEMBLE_MAX_WORKERS 1024
+
+typedef enum {
+    PARAM_SPAWN_FACTOR,
+    PARAM_MAX_FORCE_TARGET,
+    PARAM_FIRE_INTENSITY_BIAS,
+    PARAM_RANDOM_IGNITION_PROB,
+    PARAM_IGNITION_RADIUS,           // Cells around the middle of the map burning at the start, 0 for one cell
+    PARAM_COUNT
+} SweepParam;
+
+static const char* paramNames[PARAM_COUNT] = {
+    "spawn_factor", "max_force_target", "fire_intensity_bias", "random_ignition_prob", "ignition_radius"
+};
+
+static const char* engineNames[] = {"dense", "sparse", "bitsliced"};
+
+// What the spec file asks for, every parameter not listed keeps its constants.h value
+typedef struct {
+    float values[PARAM_COUNT][ENSEMBLE_MAX_VALUES];
+    unsigned int valueCounts[PARAM_COUNT];
+    unsigned int seeds;              // Runs per parameter point, the same seeds at every point
+    uint64_t firstSeed;
+    unsigned int frames;             // Steps before a run counts as not contained
+    unsigned int settle;             // Steps in a row without a burning cell before the fire counts as out
+    FireEngine engine;
+    unsigned int cols;
+    unsigned int rows;
+} SweepSpec;
+
+// One finished run, sent from a worker to the parent in a single pipe write
+typedef struct {
+    uint32_t run;
+    uint32_t contained;              // Fire out, the swarm put out the last burning cells
+    uint32_t burntOut;               // Fire out, the last burning cells burnt out on their own
+    uint32_t containmentFrame;       // First step of the quiet window, frames if the fire never went out
+    uint32_t peakBoids;
+    uint64_t cellsBurnt;
+    uint64_t cellsExtinguished;
+    double energySpent;
+} RunResult;
+
+typedef struct {
+    double sum;
+    double sumSquares;
+    double min;
+    double max;
+    unsigned int count;
+} Summary;
+
+// Results gathered for one parameter point, printed once every seed is in
+typedef struct {
+    unsigned int runs;
+    unsigned int contained;
+    unsigned int burntOut;
+    Summary containmentFrames;       // Contained runs only
+    Summary cellsBurnt;
+    Summary cellsExtinguished;
+    Summary peakBoids;
+    Summary energySpent;
+} PointSummary;
+
+// A value list ("0.5 1 2") or an inclusive range with a count ("0.3:0.9:4")
+static bool ParseValues(SweepSpec* spec, SweepParam param, char* tokens)
+{
+    spec->valueCounts[param] = 0;
+    for (char* token = strtok(tokens, " \t\r\n"); token; token = strtok(NULL, " \t\r\n"))
+    {
+        float first, last;
+        unsigned int count;
+        if (sscanf(token, "%f:%f:%u", &first, &last, &count) == 3)
+        {
+            for (unsigned int step = 0; step < count; step++)
+            {
+                if (spec->valueCounts[param] == ENSEMBLE_MAX_VALUES)
+                {
+                    return false;
+                }
+                float value = (count > 1) ? first + (last - first) * step / (count - 1) : first;
+                spec->values[param][spec->valueCounts[param]++] = value;
+            }
+        }
+        else
+        {
+            char* end;
+            float value = strtof(token, &end);
+            if (*end != '\0' || spec->valueCounts[param] == ENSEMBLE_MAX_VALUES)
+            {
+                return false;
+            }
+            spec->values[param][spec->valueCounts[param]++] = value;
+        }
+    }
+    return spec->valueCounts[param] > 0;
+}
+
+// One setting per line, "name value...", # starts a comment
+static bool LoadSweepSpec(SweepSpec* spec, const char* path)
+{
+    memset(spec, 0, sizeof(*spec));
+    const float defaults[PARAM_COUNT] = {SPAWN_FACTOR, MAX_FORCE_TARGET, FIRE_INTENSITY_BIAS_FACTOR, RANDOM_IGNITION_PROB, 0.0f};
+    for (unsigned int param = 0; param < PARAM_COUNT; param++)
+    {
+        spec->values[param][0] = defaults[param];
+        spec->valueCounts[param] = 1;
+    }
+    spec->seeds = 100;
+    spec->firstSeed = 1;
+    spec->frames = 20000;
+    spec->settle = 500;
+    spec->engine = FIRE_ENGINE;
+    spec->cols = GRID_WIDTH;
+    spec->rows = GRID_HEIGHT;
+
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "Could not open sweep spec %s\n", path);
+        return false;
+    }
+
+    char line[1024];
+    unsigned int lineNumber = 0;
+    bool valid = true;
+    while (valid && fgets(line, sizeof(line), file))
+    {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment)
+        {
+            *comment = '\0';
+        }
+
+        char name[64];
+        int consumed = 0;
+        if (sscanf(line, "%63s %n", name, &consumed) != 1)
+        {
+            continue;
+        }
+        char* rest = line + consumed;
+
+        unsigned int param = 0;
+        while (param < PARAM_COUNT && strcmp(name, paramNames[param]) != 0)
+        {
+            param++;
+        }
+
+        if (param < PARAM_COUNT)
+        {
+            valid = ParseValues(spec, (SweepParam)param, rest);
+        }
+        else if (strcmp(name, "seeds") == 0)
+        {
+            valid = sscanf(rest, "%u", &spec->seeds) == 1 && spec->seeds > 0;
+        }
+        else if (strcmp(name, "seed") == 0)
+        {
+            unsigned long long seed = 0;
+            valid = sscanf(rest, "%llu", &seed) == 1;
+            spec->firstSeed = seed;
+        }
+        else if (strcmp(name, "frames") == 0)
+        {
+            valid = sscanf(rest, "%u", &spec->frames) == 1 && spec->frames > 0;
+        }
+        else if (strcmp(name, "settle") == 0)
+        {
+            valid = sscanf(rest, "%u", &spec->settle) == 1 && spec->settle > 0;
+        }
+        else if (strcmp(name, "world") == 0)
+        {
+            valid = sscanf(rest, "%u %u", &spec->cols, &spec->rows) == 2 && spec->cols >= 16 && spec->rows >= 16;
+        }
+        else if (strcmp(name, "engine") == 0)
+        {
+            char engine[16];
+            unsigned int index = 0;
+            valid = sscanf(rest, "%15s", engine) == 1;
+            while (valid && index < 3 && strcmp(engine, engineNames[index]) != 0)
+            {
+                index++;
+            }
+            valid = valid && index < 3;
+            spec->engine = (FireEngine)index;
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+    fclose(file);
+
+    if (!valid)
+    {
+        fprintf(stderr, "Sweep spec %s: cannot read line %u\n", path, lineNumber);
+        return false;
+    }
+    if (!IsWorldSizeSupported(spec->engine, spec->cols, spec->rows))
+    {
+        fprintf(stderr, "Sweep spec %s: a %ux%u world is too large for the %s engine, use sparse\n", path, spec->cols,
+                spec->rows, engineNames[spec->engine]);
+        return false;
+    }
+    return true;
+}
+
+static unsigned int CountPoints(const SweepSpec* spec)
+{
+    unsigned int points = 1;
+    for (unsigned int param = 0; param < PARAM_COUNT; param++)
+    {
+        points *= spec->valueCounts[param];
+    }
+    return points;
+}
+
+// Parameter point index to one value per parameter, the last parameter varies fastest
+static void GetPointValues(const SweepSpec* spec, unsigned int point, float values[PARAM_COUNT])
+{
+    for (int param = PARAM_COUNT - 1; param >= 0; param--)
+    {
+        values[param] = spec->values[param][point % spec->valueCounts[param]];
+        point /= spec->valueCounts[param];
+    }
+}
+
+// Sets every cell within radius cells of the middle of the map burning
+static void IgniteStart(Grid* grid, float radius)
+{
+    int centerRow = grid->rows / 2;
+    int centerCol = grid->cols / 2;
+    int reach = (int)radius;
+    for (int row = centerRow - reach; row <= centerRow + reach; row++)
+    {
+        for (int col = centerCol - reach; col <= centerCol + reach; col++)
+        {
+            int rowOffset = row - centerRow;
+            int colOffset = col - centerCol;
+            if (row >= 0 && col >= 0 && (unsigned int)row < grid->rows && (unsigned int)col < grid->cols &&
+                rowOffset * rowOffset + colOffset * colOffset <= radius * radius)
+            {
+                IgniteCell(grid, row, col);
+            }
+        }
+    }
+}
+
+// Single-threaded, from a fire in the middle of the map until no cell has burnt for settle steps or the
+// frame limit. A random ignition inside the quiet window starts it over.
+static void RunOne(const SweepSpec* spec, unsigned int run, RunResult* result)
+{
+    float values[PARAM_COUNT];
+    GetPointValues(spec, run / spec->seeds, values);
+
+    Simulation sim;
+    InitializeSimulationThreads(&sim, spec->firstSeed + run % spec->seeds, spec->engine, spec->cols, spec->rows, 1);
+    sim.spawnFactor = values[PARAM_SPAWN_FACTOR];
+    sim.maxForceTarget = values[PARAM_MAX_FORCE_TARGET];
+    sim.grid.fireIntensityBias = values[PARAM_FIRE_INTENSITY_BIAS];
+    sim.grid.ignitionProbability = values[PARAM_RANDOM_IGNITION_PROB];
+    sim.trackEnergy = true;
+    IgniteStart(&sim.grid, values[PARAM_IGNITION_RADIUS]);
+
+    memset(result, 0, sizeof(*result));
+    result->run = run;
+    result->containmentFrame = spec->frames;
+    result->peakBoids = sim.swarm.count;
+    unsigned int quietSince = 0;
+    bool putOut = false;             // Whether the step that left no cell burning extinguished any
+    for (unsigned int frame = 1; frame <= spec->frames; frame++)
+    {
+        uint64_t extinguished = sim.grid.cellCounts[3];
+        StepSimulation(&sim, 1);
+        if (sim.swarm.count > result->peakBoids) result->peakBoids = sim.swarm.count;
+        if (sim.grid.cellCounts[1] != 0)
+        {
+            quietSince = 0;
+        }
+        else if (quietSince == 0)
+        {
+            quietSince = frame;
+            putOut = sim.grid.cellCounts[3] > extinguished;
+        }
+        if (quietSince != 0 && frame - quietSince + 1 >= spec->settle)
+        {
+            result->contained = putOut;
+            result->burntOut = !putOut;
+            result->containmentFrame = quietSince;
+            break;
+        }
+    }
+
+    result->cellsBurnt = sim.grid.cellCounts[2];
+    result->cellsExtinguished = sim.grid.cellCounts[3];
+    result->energySpent = sim.energySpent;
+    FreeSimulation(&sim);
+}
+
+// Takes runs off the shared counter until none are left. Results fit in one pipe write, so several
+// workers can share the pipe without their records interleaving.
+static void WorkerMain(const SweepSpec* spec, unsigned int runCount, unsigned int* nextRun, int output)
+{
+    for (;;)
+    {
+        unsigned int run = __atomic_fetch_add(nextRun, 1, __ATOMIC_RELAXED);
+        if (run >= runCount)
+        {
+            break;
+        }
+
+        RunResult result;
+        RunOne(spec, run, &result);
+        if (write(output, &result, sizeof(result)) != sizeof(result))
+        {
+            fprintf(stderr, "Worker could not report run %u\n", run);
+            _exit(1);
+        }
+    }
+    _exit(0);
+}
+
+static void AddSample(Summary* summary, double value)
+{
+    if (summary->count == 0 || value < summary->min) summary->min = value;
+    if (summary->count == 0 || value > summary->max) summary->max = value;
+    summary->sum += value;
+    summary->sumSquares += value * value;
+    summary->count++;
+}
+
+static void PrintSummary(const char* name, const Summary* summary)
+{
+    if (summary->count == 0)
+    {
+        printf(",\"%s\":null", name);
+        return;
+    }
+    double mean = summary->sum / summary->count;
+    double variance = summary->count > 1 ? (summary->sumSquares - summary->sum * mean) / (summary->count - 1) : 0.0;
+    printf(",\"%s\":{\"mean\":%.3f,\"stddev\":%.3f,\"min\":%.3f,\"max\":%.3f}", name, mean,
+           sqrt(variance > 0 ? variance : 0), summary->min, summary->max);
+}
+
+static void PrintPoint(const SweepSpec* spec, unsigned int point, const PointSummary* summary)
+{
+    float values[PARAM_COUNT];
+    GetPointValues(spec, point, values);
+
+    printf("{\"point\":%u", point);
+    for (unsigned int param = 0; param < PARAM_COUNT; param++)
+    {
+        printf(",\"%s\":%g", paramNames[param], values[param]);
+    }
+    printf(",\"runs\":%u,\"contained\":%u,\"burnt_out\":%u", summary->runs, summary->contained, summary->burntOut);
+    PrintSummary("containment_frames", &summary->containmentFrames);
+    PrintSummary("cells_burnt", &summary->cellsBurnt);
+    PrintSummary("cells_extinguished", &summary->cellsExtinguished);
+    PrintSummary("peak_boids", &summary->peakBoids);
+    PrintSummary("energy_spent", &summary->energySpent);
+    printf("}\n");
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s spec.txt [workers]\n", argv[0]);
+        return 1;
+    }
+
+    SweepSpec spec;
+    if (!LoadSweepSpec(&spec, argv[1]))
+    {
+        return 1;
+    }
+
+    // Random streams are per process, so runs go to worker processes rather than threads
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int workers = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 0) : (cores > 0 ? (unsigned int)cores : 1);
+    if (workers < 1) workers = 1;
+    if (workers > ENSEMBLE_MAX_WORKERS) workers = ENSEMBLE_MAX_WORKERS;
+
+    unsigned int pointCount = CountPoints(&spec);
+    unsigned long long runTotal = (unsigned long long)pointCount * spec.seeds;
+    if (runTotal > UINT32_MAX)
+    {
+        fprintf(stderr, "Sweep of %llu runs is too large\n", runTotal);
+        return 1;
+    }
+    unsigned int runCount = (unsigned int)runTotal;
+
+    printf("{\"ensemble\":\"boid-firefight\",\"engine\":\"%s\",\"world\":\"%ux%u\",\"frames\":%u,\"settle\":%u,\"points\":%u,\"seeds\":%u,\"first_seed\":%llu,\"workers\":%u}\n",
+           engineNames[spec.engine], spec.cols, spec.rows, spec.frames, spec.settle, pointCount, spec.seeds,
+           (unsigned long long)spec.firstSeed, workers);
+    fflush(stdout);
+
+    PointSummary* points = (PointSummary*)calloc(pointCount, sizeof(PointSummary));
+    unsigned int* nextRun = (unsigned int*)mmap(NULL, sizeof(unsigned int), PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (!points || nextRun == MAP_FAILED)
+    {
+        fprintf(stderr, "Memory allocation failed for ensemble results\n");
+        exit(1);
+    }
+    *nextRun = 0;
+
+    int results[2];
+    if (pipe(results) != 0)
+    {
+        fprintf(stderr, "Could not create ensemble result pipe\n");
+        return 1;
+    }
+
+    unsigned int started = 0;
+    for (; started < workers; started++)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            fprintf(stderr, "Could not start ensemble worker %u\n", started);
+            break;
+        }
+        if (pid == 0)
+        {
+            close(results[0]);
+            WorkerMain(&spec, runCount, nextRun, results[1]);
+        }
+    }
+    close(results[1]);
+
+    // Points are printed as soon as their last seed comes in, runs are handed out point by point
+    unsigned int received = 0;
+    RunResult result;
+    while (started > 0 && read(results[0], &result, sizeof(result)) == sizeof(result))
+    {
+        PointSummary* point = &points[result.run / spec.seeds];
+        point->runs++;
+        point->contained += result.contained;
+        point->burntOut += result.burntOut;
+        if (result.contained)
+        {
+            AddSample(&point->containmentFrames, result.containmentFrame);
+        }
+        AddSample(&point->cellsBurnt, (double)result.cellsBurnt);
+        AddSample(&point->cellsExtinguished, (double)result.cellsExtinguished);
+        AddSample(&point->peakBoids, result.peakBoids);
+        AddSample(&point->energySpent, result.energySpent);
+        received++;
+
+        if (point->runs == spec.seeds)
+        {
+            PrintPoint(&spec, result.run / spec.seeds, point);
+        }
+    }
+    close(results[0]);
+
+    bool workersOk = true;
+    for (unsigned int worker = 0; worker < started; worker++)
+    {
+        int status;
+        if (wait(&status) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            workersOk = false;
+        }
+    }
+
+    munmap(nextRun, sizeof(unsigned int));
+    free(points);
+    if (!workersOk || received != runCount)
+    {
+        fprintf(stderr, "Ensemble finished %u of %u runs\n", received, runCount);
+        return 1;
+    }
+    return 0;
+}
@@ -3,7 +3,7 @@
  * Project:        Boid Swarm Firefight
  * Author:         Peter Ryseck
  * Date Created:   February 8, 2025
- * Last Updated:   February 8, 2025
+ * Last Updated:   October 16, 2026
  *
  * Description:    Logic for wildfire spread and grid operations
  ******************************************************/
@@ -13,155 +13,522 @@
 #include "math.h"
 #include "utils.h"
 #include "constants.h"
+#include "profile.h"
+#include <float.h>
 #include <stdio.h>
+#include <string.h>
 
-// Function to initialize the grid
-void InitializeGrid(Grid* grid) {
-    grid->rows = GRID_HEIGHT;
-    grid->cols = GRID_WIDTH;
+static void PushCell(CellList* list, uint64_t cell) {
+    if (list->count == list->capacity) {
+        unsigned int newCapacity = list->capacity ? list->capacity * 2 : 64;
+        uint64_t* newCells = (uint64_t*)realloc(list->cells, newCapacity * sizeof(uint64_t));
+        if (!newCells) {
+            fprintf(stderr, "Memory allocation failed for cell list\n");
+            exit(1);
+        }
+        list->cells = newCells;
+        list->capacity = newCapacity;
+    }
+    list->cells[list->count++] = cell;
+}
+
+unsigned int GetSectionIndex(const Grid* grid, unsigned int row, unsigned int col) {
+    unsigned int sectionX = col / (grid->cols / grid->numSectionsX);
+    unsigned int sectionY = row / (grid->rows / grid->numSectionsY);
+
+    // Leftover cells from uneven division belong to the last section
+    if (sectionX >= grid->numSectionsX) sectionX = grid->numSectionsX - 1;
+    if (sectionY >= grid->numSectionsY) sectionY = grid->numSectionsY - 1;
+
+    return sectionY * grid->numSectionsX + sectionX;
+}
 
-    grid->cells = (Cell**)malloc(grid->rows * sizeof(Cell*));
-    if (!grid->cells) {
-        fprintf(stderr, "Memory allocation failed for grid rows\n");
+// Cells along one side of a section, the last one also takes the leftover cells
+static unsigned int GetSectionSpan(unsigned int cells, unsigned int sections, unsigned int section) {
+    unsigned int span = cells / sections;
+    return (section + 1 == sections) ? cells - section * span : span;
+}
+
+bool IsWorldSizeSupported(FireEngine engine, unsigned int cols, unsigned int rows) {
+    return engine == FIRE_ENGINE_SPARSE || (uint64_t)cols * rows <= FULL_GRID_MAX_CELLS;
+}
+
+// Function to initialize the grid, cols by rows cells. Storage is only allocated for chunks that
+// fire reaches (all of them for the dense engine), so the world may be far larger than the screen.
+void InitializeGrid(Grid* grid, FireEngine engine, unsigned int cols, unsigned int rows,
+                    unsigned int numSectionsX, unsigned int numSectionsY) {
+    if (!IsWorldSizeSupported(engine, cols, rows)) {
+        fprintf(stderr, "World of %ux%u cells is too large for the dense and bit-sliced engines, use the sparse engine\n",
+                cols, rows);
         exit(1);
     }
 
-    for (unsigned int rowIndex = 0; rowIndex < grid->rows; ++rowIndex) {
-        grid->cells[rowIndex] = (Cell*)malloc(grid->cols * sizeof(Cell));
-        if (!grid->cells[rowIndex]) {
-            fprintf(stderr, "Memory allocation failed for grid columns\n");
-            exit(1);
+    grid->rows = rows;
+    grid->cols = cols;
+    grid->engine = engine;
+    grid->numSectionsX = numSectionsX;
+    grid->numSectionsY = numSectionsY;
+    grid->ignitionProbability = RANDOM_IGNITION_PROB;
+    grid->fireIntensityBias = FIRE_INTENSITY_BIAS_FACTOR;
+    grid->tick = 0;
+    grid->cellsScanned = 0;
+
+    InitializeChunks(grid);
+
+    grid->sectionCounts = (uint64_t*)calloc(numSectionsX * numSectionsY * CELL_STATE_COUNT, sizeof(uint64_t));
+    grid->sectionFire = (float*)calloc(numSectionsX * numSectionsY, sizeof(float));
+    grid->sectionBoids = (unsigned int*)calloc(numSectionsX * numSectionsY, sizeof(unsigned int));
+    grid->front = (FireFront){0};
+    if (!grid->sectionCounts || !grid->sectionFire || !grid->sectionBoids) {
+        fprintf(stderr, "Memory allocation failed for fire front\n");
+        exit(1);
+    }
+
+    // Every cell starts unburnt, from here on the counters only move with SetCellState
+    for (unsigned int sectionY = 0; sectionY < numSectionsY; ++sectionY) {
+        for (unsigned int sectionX = 0; sectionX < numSectionsX; ++sectionX) {
+            grid->sectionCounts[(sectionY * numSectionsX + sectionX) * CELL_STATE_COUNT] =
+                (uint64_t)GetSectionSpan(cols, numSectionsX, sectionX) * GetSectionSpan(rows, numSectionsY, sectionY);
         }
+    }
+    memset(grid->cellCounts, 0, sizeof(grid->cellCounts));
+    grid->cellCounts[0] = (uint64_t)rows * cols;
+
+    unsigned int tileCount = (grid->rows + FIRE_TILE_ROWS - 1) / FIRE_TILE_ROWS;
+    grid->tileCounts = (int*)calloc(tileCount * numSectionsX * numSectionsY * CELL_STATE_COUNT, sizeof(int));
+    if (!grid->tileCounts) {
+        fprintf(stderr, "Memory allocation failed for fire tiles\n");
+        exit(1);
+    }
+    grid->pool = NULL;
 
-        for (unsigned int colIndex = 0; colIndex < grid->cols; ++colIndex) {
-            grid->cells[rowIndex][colIndex].state = 0;  // Set to unburnt initially
-            grid->cells[rowIndex][colIndex].timer = 0;
+    // Every row starts dirty so the first render uploads the whole grid
+    grid->dirtyRows = (unsigned char*)malloc(grid->rows);
+    if (!grid->dirtyRows) {
+        fprintf(stderr, "Memory allocation failed for dirty rows\n");
+        exit(1);
+    }
+    memset(grid->dirtyRows, DIRTY_ROW_ALL, grid->rows);
+
+    // The dense engine visits every cell each step anyway, so every chunk is live from the start
+    if (engine == FIRE_ENGINE_DENSE) {
+        for (unsigned int chunkIndex = 0; chunkIndex < grid->chunkRows * grid->chunkCols; ++chunkIndex) {
+            MakeChunkLive(grid, chunkIndex);
         }
     }
+
+    grid->planes = (FireBitplanes){0};
+    if (engine == FIRE_ENGINE_BITSLICED) {
+        InitializeFireBitplanes(grid);
+    }
 }
 
-Grid* CopyGrid(Grid* grid) 
-{
-    Grid* newGrid = (Grid*)malloc(sizeof(Grid));
-    newGrid->rows = grid->rows;
-    newGrid->cols = grid->cols;
+void FreeGrid(Grid* grid) {
+    FreeChunks(grid);
+    free(grid->sectionCounts);
+    free(grid->sectionFire);
+    free(grid->sectionBoids);
+    free(grid->tileCounts);
+    free(grid->dirtyRows);
+    free(grid->front.burning.cells);
+    for (unsigned int slot = 0; slot < BURNOUT_WHEEL_SIZE; ++slot) {
+        free(grid->front.wheel[slot].cells);
+    }
+    FreeFireBitplanes(grid);
+}
 
-    newGrid->cells = (Cell**)malloc(grid->rows * sizeof(Cell*));
-    for (unsigned int rowIndex = 0; rowIndex < grid->rows; ++rowIndex)
-    {
-        newGrid->cells[rowIndex] = (Cell*)malloc(grid->cols * sizeof(Cell));
-        for (unsigned int colIndex = 0; colIndex < grid->cols; ++colIndex)
-        {
-            newGrid->cells[rowIndex][colIndex] = grid->cells[rowIndex][colIndex];
-        }
+// Burnout tick of a burning cell from the low byte kept in its timer, it is always within the next BURNING_DURATION ticks
+unsigned int GetBurnoutTick(const Grid* grid, const Cell* cell) {
+    return grid->tick + ((cell->timer - grid->tick) & 0xFF);
+}
+
+// Every state change of a cell in the current buffer goes through here, so the section, chunk and grid
+// counters always match the cells. Engine bookkeeping (burning lists, bitplanes, timers) is up to the caller.
+// Safe to call from several threads at once for different cells of live chunks.
+void SetCellState(Grid* grid, unsigned int row, unsigned int col, unsigned char state) {
+    unsigned char previous = GetCellState(grid, row, col);
+    if (previous == state) {
+        return;
     }
 
-    return newGrid;
+    CellChunk* chunk = GetLiveChunk(grid, row, col);
+    uint64_t* counts = &grid->sectionCounts[GetSectionIndex(grid, row, col) * CELL_STATE_COUNT];
+    __atomic_fetch_sub(&counts[previous], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&counts[state], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&grid->cellCounts[previous], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&grid->cellCounts[state], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&chunk->counts[previous], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&chunk->counts[state], 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&chunk->lastChange, grid->tick, __ATOMIC_RELAXED);
+
+    chunk->cells[GetChunkOffset(row, col)].state = state;
+    MarkRowDirty(grid, row);
+    PROFILE_COUNT(PROFILE_CELLS_CHANGED, 1);
 }
 
-void UpdateGridAndCalculateIntensity(Grid *grid, float **sectionIntensity, Boid *boids, unsigned int numBoids,
-                                     unsigned int numSectionsX, unsigned int numSectionsY, float* totalBurning, float spreadProbability)
-{
-    Grid *newGrid = CopyGrid(grid);
+uint64_t GetSectionCount(const Grid* grid, unsigned int sectionIndex, unsigned char state) {
+    return grid->sectionCounts[sectionIndex * CELL_STATE_COUNT + state];
+}
 
-    unsigned int sectionWidth = grid->cols / numSectionsX;
-    unsigned int sectionHeight = grid->rows / numSectionsY;
-    float idealBoidCount = (float)numBoids / (numSectionsX * numSectionsY);
-    *totalBurning = 0;
+// Set a cell burning for BURNING_DURATION steps, usable between steps and by the engines
+void IgniteCell(Grid* grid, unsigned int row, unsigned int col) {
+    CellChunk* chunk = GetLiveChunk(grid, row, col);
+    unsigned int offset = GetChunkOffset(row, col);
+    Cell* cell = &chunk->cells[offset];
 
-    // Allocate and initialize arrays for fire intensities and boid counts
-    float *fireIntensities = (float *)calloc(numSectionsX * numSectionsY, sizeof(float));
-    unsigned int *boidCounts = (unsigned int *)calloc(numSectionsX * numSectionsY, sizeof(unsigned int));
+    if (grid->engine == FIRE_ENGINE_DENSE) {
+        SetCellState(grid, row, col, 1);
+        cell->timer = BURNING_DURATION;
+        return;
+    }
 
-    // Precompute boid counts for all sections
-    for (unsigned int index = 0; index < numBoids; ++index) {
-        Boid *boid = &boids[index];
-        if (!boid->headingHome) {
-            unsigned int boidRow = (unsigned int)(boid->posy / CELL_SIZE);
-            unsigned int boidCol = (unsigned int)(boid->posx / CELL_SIZE);
+    uint64_t index = (uint64_t)row * grid->cols + col;
 
-            unsigned int sectionX = boidCol / sectionWidth;
-            unsigned int sectionY = boidRow / sectionHeight;
+    if (cell->state == 1 && grid->engine == FIRE_ENGINE_BITSLICED) {
+        ClearBitplaneBurning(grid, row, col, GetBurnoutTick(grid, cell));
+    }
 
-            if (sectionX < numSectionsX && sectionY < numSectionsY) {
-                boidCounts[sectionY * numSectionsX + sectionX]++;
-            }
-        }
+    // Timer holds the low byte of the burnout tick, so stale wheel entries can be told apart
+    unsigned int burnoutTick = grid->tick + BURNING_DURATION;
+    SetCellState(grid, row, col, 1);
+    cell->timer = burnoutTick & 0xFF;
+
+    if (grid->engine == FIRE_ENGINE_BITSLICED) {
+        SetBitplaneBurning(grid, row, col, burnoutTick);
+        return;
     }
 
-    for (unsigned int sectionY = 0; sectionY < numSectionsY; ++sectionY) {
-        for (unsigned int sectionX = 0; sectionX < numSectionsX; ++sectionX) {
-            unsigned int startRow = sectionY * sectionHeight;
-            unsigned int startCol = sectionX * sectionWidth;
-            unsigned int endRow = (startRow + sectionHeight < grid->rows) ? startRow + sectionHeight : grid->rows;
-            unsigned int endCol = (startCol + sectionWidth < grid->cols) ? startCol + sectionWidth : grid->cols;
-            bool hasBurningCells = false;
-
-            for (unsigned int rowIndex = startRow; rowIndex < endRow; ++rowIndex) {
-                for (unsigned int colIndex = startCol; colIndex < endCol; ++colIndex) {
-                    Cell *cell = &grid->cells[rowIndex][colIndex];
-                    
-                    if (cell->state == 1) { // Cell is burning
-                        hasBurningCells = true;
-                        newGrid->cells[rowIndex][colIndex].timer -= 1;
-                        if (newGrid->cells[rowIndex][colIndex].timer <= 0) {
-                            newGrid->cells[rowIndex][colIndex].state = 2; // Change to burnt
-                        }
+    FireFront* front = &grid->front;
+    PushCell(&front->wheel[burnoutTick % BURNOUT_WHEEL_SIZE], index);
 
-                        // Spread fire to neighbors
-                        int directions[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    if (!chunk->listed[offset]) {
+        chunk->listed[offset] = 1;
+        chunk->listedCount++;
+        PushCell(&front->burning, index);
+    }
+}
+
+// Safe to call from several threads at once for different burning cells
+void ExtinguishCell(Grid* grid, unsigned int row, unsigned int col) {
+    Cell* cell = GetCell(grid, row, col);
+
+    // The sparse engine drops the cell from its burning list on the next step
+    if (grid->engine == FIRE_ENGINE_BITSLICED && (cell->state == 0 || cell->state == 1)) {
+        ClearBitplaneBurning(grid, row, col, GetBurnoutTick(grid, cell));
+    }
+    SetCellState(grid, row, col, 3);
+}
+
+// Claims are only made on burning cells, which are always in live chunks
+static unsigned int* GetClaim(const Grid* grid, unsigned int row, unsigned int col) {
+    return &grid->chunks[GetChunkIndex(grid, row, col)].live->claims[GetChunkOffset(row, col)];
+}
+
+// Offers a cell to a boid from any thread, the lowest boid index offered the cell keeps the claim
+void ClaimCell(Grid* grid, unsigned int row, unsigned int col, unsigned int claimant) {
+    unsigned int* claim = GetClaim(grid, row, col);
+    unsigned int current = __atomic_load_n(claim, __ATOMIC_RELAXED);
+    while (claimant < current &&
+           !__atomic_compare_exchange_n(claim, &current, claimant, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+bool HoldsClaim(const Grid* grid, unsigned int row, unsigned int col, unsigned int claimant) {
+    return __atomic_load_n(GetClaim(grid, row, col), __ATOMIC_RELAXED) == claimant;
+}
+
+void ReleaseClaim(Grid* grid, unsigned int row, unsigned int col) {
+    __atomic_store_n(GetClaim(grid, row, col), CELL_UNCLAIMED, __ATOMIC_RELAXED);
+}
+
+static void SwapGridBuffers(Grid* grid) {
+    for (unsigned int position = 0; position < grid->liveCount; ++position) {
+        CellChunk* chunk = grid->chunks[grid->liveChunks[position]].live;
+        Cell* cells = chunk->cells;
+        chunk->cells = chunk->nextCells;
+        chunk->nextCells = cells;
+    }
+}
+
+typedef struct {
+    Grid *grid;
+    float spreadProbability;
+    uint64_t spreadKey;
+} DenseFireTask;
+
+// Change in cells per state and section for one tile, applied to the counters once every tile is done
+static int *GetTileCounts(const Grid *grid, unsigned int tile) {
+    return &grid->tileCounts[tile * grid->numSectionsX * grid->numSectionsY * CELL_STATE_COUNT];
+}
+
+// Cells of one row of a live chunk, or NULL past the edge of the world
+static const Cell *GetChunkRow(const Grid *grid, int row, int chunkCol) {
+    if (row < 0 || row >= (int)grid->rows || chunkCol < 0 || chunkCol >= (int)grid->chunkCols) {
+        return NULL;
+    }
+    const CellChunk *chunk = grid->chunks[(row >> CHUNK_SHIFT) * grid->chunkCols + chunkCol].live;
+    return &chunk->cells[(row & CHUNK_MASK) * CHUNK_SIZE];
+}
+
+// Next state of one band of FIRE_TILE_ROWS rows, pulled from the cell and its four neighbors in the
+// current buffer. Each burning neighbor gets its own draw, numbered by tick, cell and direction, so the
+// result does not depend on which thread runs the tile or in what order.
+static void StepDenseTile(void *context, unsigned int begin, unsigned int end, unsigned int thread) {
+    DenseFireTask *task = (DenseFireTask *)context;
+    (void)thread;
+    Grid *grid = task->grid;
+    unsigned int rows = grid->rows;
+    unsigned int cols = grid->cols;
+    unsigned int numSections = grid->numSectionsX * grid->numSectionsY;
+    uint64_t stepCounter = (uint64_t)grid->tick * rows * cols;
+    uint64_t changedCells = 0;
+
+    for (unsigned int tile = begin; tile < end; ++tile) {
+        int *counts = GetTileCounts(grid, tile);
+        memset(counts, 0, numSections * CELL_STATE_COUNT * sizeof(int));
+
+        unsigned int startRow = tile * FIRE_TILE_ROWS;
+        unsigned int endRow = (startRow + FIRE_TILE_ROWS < rows) ? startRow + FIRE_TILE_ROWS : rows;
+
+        for (unsigned int rowIndex = startRow; rowIndex < endRow; ++rowIndex) {
+            bool changed = false;
+
+            // One chunk-wide span at a time, the halo cells around it may belong to other tiles and chunks
+            // and are only read
+            for (unsigned int chunkCol = 0; chunkCol < grid->chunkCols; ++chunkCol) {
+                unsigned int firstCol = chunkCol << CHUNK_SHIFT;
+                unsigned int spanCols = (firstCol + CHUNK_SIZE < cols) ? CHUNK_SIZE : cols - firstCol;
+                const Cell *above = GetChunkRow(grid, (int)rowIndex - 1, chunkCol);
+                const Cell *row = GetChunkRow(grid, rowIndex, chunkCol);
+                const Cell *below = GetChunkRow(grid, rowIndex + 1, chunkCol);
+                const Cell *left = GetChunkRow(grid, rowIndex, (int)chunkCol - 1);
+                const Cell *right = GetChunkRow(grid, rowIndex, chunkCol + 1);
+                CellChunk *chunk = grid->chunks[GetChunkIndex(grid, rowIndex, firstCol)].live;
+                Cell *next = &chunk->nextCells[(rowIndex & CHUNK_MASK) * CHUNK_SIZE];
+                int chunkCounts[CELL_STATE_COUNT] = {0};
+                bool chunkChanged = false;
+
+                for (unsigned int offset = 0; offset < spanCols; ++offset) {
+                    unsigned int colIndex = firstCol + offset;
+                    Cell cell = row[offset];
+
+                    if (cell.state == 1) { // Cell is burning
+                        cell.timer -= 1;
+                        if (cell.timer <= 0) {
+                            cell.state = 2; // Change to burnt
+                        }
+                    } else if (cell.state == 0) {
+                        bool neighbors[4] = {
+                            above && above[offset].state == 1,
+                            below && below[offset].state == 1,
+                            (offset > 0) ? row[offset - 1].state == 1 : left && left[CHUNK_SIZE - 1].state == 1,
+                            (offset + 1 < spanCols) ? row[offset + 1].state == 1 : right && right[0].state == 1
+                        };
+                        uint64_t counter = (stepCounter + (uint64_t)rowIndex * cols + colIndex) * 4;
                         for (unsigned int dirIndex = 0; dirIndex < 4; ++dirIndex) {
-                            int newRow = rowIndex + directions[dirIndex][0];
-                            int newCol = colIndex + directions[dirIndex][1];
-                            if (newRow >= 0 && newRow < grid->rows && newCol >= 0 && newCol < grid->cols) {
-                                Cell *neighbor = &grid->cells[newRow][newCol];
-                                if (neighbor->state == 0 && GetRandomFloat(0.0f, 1.0f) < spreadProbability) {
-                                    newGrid->cells[newRow][newCol].state = 1;  // Change to burning
-                                    newGrid->cells[newRow][newCol].timer = BURNING_DURATION;
-                                }
+                            if (neighbors[dirIndex] &&
+                                RngToUnit(RngAt(task->spreadKey, counter + dirIndex)) < task->spreadProbability) {
+                                cell.state = 1;  // Change to burning
+                                cell.timer = BURNING_DURATION;
+                                break;
                             }
                         }
-                        
-                        fireIntensities[sectionY * numSectionsX + sectionX] += 1.0f * FIRE_INTENSITY_BIAS_FACTOR;
-                        *totalBurning += 1.0f;
                     }
+
+                    // The tile writes the next buffer in bulk, so it keeps its own deltas instead of calling SetCellState
+                    if (cell.state != row[offset].state) {
+                        unsigned int section = GetSectionIndex(grid, rowIndex, colIndex);
+                        counts[section * CELL_STATE_COUNT + row[offset].state]--;
+                        counts[section * CELL_STATE_COUNT + cell.state]++;
+                        chunkCounts[row[offset].state]--;
+                        chunkCounts[cell.state]++;
+                        chunkChanged = true;
+                        changedCells++;
+                    }
+                    next[offset] = cell;
                 }
-            }
-            
-            if (!hasBurningCells) {
-                for (unsigned int rowIndex = startRow; rowIndex < endRow; ++rowIndex) {
-                    for (unsigned int colIndex = startCol; colIndex < endCol; ++colIndex) {
-                        Cell *cell = &grid->cells[rowIndex][colIndex];
-                        if (cell->state == 2 || cell->state == 3) { // Cell is burnt or extinguished
-                            fireIntensities[sectionY * numSectionsX + sectionX] -= 1.0f * SPREAD_INTENSITY_BIAS_FACTOR;
-                        }
+
+                // Other tiles write other rows of the same chunk
+                if (chunkChanged) {
+                    for (unsigned int state = 0; state < CELL_STATE_COUNT; ++state) {
+                        __atomic_fetch_add(&chunk->counts[state], chunkCounts[state], __ATOMIC_RELAXED);
                     }
+                    __atomic_store_n(&chunk->lastChange, grid->tick, __ATOMIC_RELAXED);
+                    changed = true;
+                }
+            }
+
+            if (changed) {
+                MarkRowDirty(grid, rowIndex);
+            }
+        }
+    }
+    PROFILE_COUNT(PROFILE_CELLS_CHANGED, changedCells);
+}
+
+static void StepDenseFire(Grid *grid, float spreadProbability)
+{
+    grid->tick++;
+
+    unsigned int numSections = grid->numSectionsX * grid->numSectionsY;
+    unsigned int tileCount = (grid->rows + FIRE_TILE_ROWS - 1) / FIRE_TILE_ROWS;
+    DenseFireTask task = {grid, spreadProbability, RngStreamKey(GetRandomSeed(), RNG_STREAM_SPREAD, 0)};
+    RunParallel(grid->pool, tileCount, 1, StepDenseTile, &task);
+    uint64_t scanned = (uint64_t)grid->rows * grid->cols;
+    grid->cellsScanned += scanned;
+    PROFILE_COUNT(PROFILE_CELLS_SCANNED, scanned);
+
+    // Apply the tile deltas, they are integers so the sums do not depend on the order
+    for (unsigned int tile = 0; tile < tileCount; ++tile) {
+        const int *counts = GetTileCounts(grid, tile);
+        for (unsigned int index = 0; index < numSections * CELL_STATE_COUNT; ++index) {
+            grid->sectionCounts[index] += counts[index];
+            grid->cellCounts[index % CELL_STATE_COUNT] += counts[index];
+        }
+    }
+
+    SwapGridBuffers(grid);
+
+    // Random ignition
+    if (GetRandomFloat(RNG_STREAM_IGNITION, 0.0f, 1.0f) < grid->ignitionProbability) {
+        unsigned int randomRow = (unsigned int)GetRandomFloat(RNG_STREAM_IGNITION, 5, grid->rows - 5);
+        unsigned int randomCol = (unsigned int)GetRandomFloat(RNG_STREAM_IGNITION, 5, grid->cols - 5);
+        if (GetCellState(grid, randomRow, randomCol) == 0) {
+            IgniteCell(grid, randomRow, randomCol);
+        }
+    }
+}
+
+static void StepSparseFire(Grid *grid, float spreadProbability)
+{
+    FireFront *front = &grid->front;
+    unsigned int cols = grid->cols;
+    unsigned int rows = grid->rows;
+    unsigned int burningCount = front->burning.count;
+    unsigned int kept = 0;
+    RngStream *spread = GetRngStream(RNG_STREAM_SPREAD);
+
+    grid->tick++;
+
+    // Spread from cells burning at the start of the step, cells ignited here are appended past burningCount
+    // so they only start spreading next step
+    for (unsigned int entry = 0; entry < burningCount; ++entry) {
+        uint64_t index = front->burning.cells[entry];
+        unsigned int rowIndex = index / cols;
+        unsigned int colIndex = index % cols;
+
+        // Listed cells keep their chunk live
+        CellChunk *chunk = grid->chunks[GetChunkIndex(grid, rowIndex, colIndex)].live;
+        unsigned int offset = GetChunkOffset(rowIndex, colIndex);
+        if (chunk->cells[offset].state != 1) {
+            chunk->listed[offset] = 0; // Burnt out or extinguished since last step
+            chunk->listedCount--;
+            continue;
+        }
+        front->burning.cells[kept++] = index;
+
+        int directions[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+        for (unsigned int dirIndex = 0; dirIndex < 4; ++dirIndex) {
+            int newRow = rowIndex + directions[dirIndex][0];
+            int newCol = colIndex + directions[dirIndex][1];
+            if (newRow >= 0 && (unsigned int)newRow < rows && newCol >= 0 && (unsigned int)newCol < cols) {
+                if (GetCellState(grid, newRow, newCol) == 0 && RngUniform(spread) < spreadProbability) {
+                    IgniteCell(grid, newRow, newCol);
                 }
             }
         }
     }
 
+    // Close the gap left by dropped entries
+    unsigned int ignited = front->burning.count - burningCount;
+    memmove(&front->burning.cells[kept], &front->burning.cells[burningCount], ignited * sizeof(uint64_t));
+    front->burning.count = kept + ignited;
+
+    // Burn out the cells scheduled for this tick, skipping entries for cells put out or relit since
+    CellList *slot = &front->wheel[grid->tick % BURNOUT_WHEEL_SIZE];
+    for (unsigned int entry = 0; entry < slot->count; ++entry) {
+        uint64_t index = slot->cells[entry];
+        unsigned int rowIndex = index / cols;
+        unsigned int colIndex = index % cols;
+        if (GetCellState(grid, rowIndex, colIndex) == 1 && GetCell(grid, rowIndex, colIndex)->timer == (grid->tick & 0xFF)) {
+            SetCellState(grid, rowIndex, colIndex, 2); // Change to burnt
+        }
+    }
+    // Each listed cell, its four neighbors and each wheel entry
+    uint64_t scanned = burningCount + 4 * (uint64_t)kept + slot->count;
+    grid->cellsScanned += scanned;
+    PROFILE_COUNT(PROFILE_CELLS_SCANNED, scanned);
+    slot->count = 0;
+
     // Random ignition
-    if (GetRandomFloat(0.0f, 1.0f) < RANDOM_IGNITION_PROB) {
-        unsigned int randomRow = (unsigned int)GetRandomFloat(5, grid->rows - 5);
-        unsigned int randomCol = (unsigned int)GetRandomFloat(5, grid->cols - 5);
-        if (newGrid->cells[randomRow][randomCol].state == 0) {
-            newGrid->cells[randomRow][randomCol].state = 1;  // Change to burning
-            newGrid->cells[randomRow][randomCol].timer = BURNING_DURATION;
+    if (GetRandomFloat(RNG_STREAM_IGNITION, 0.0f, 1.0f) < grid->ignitionProbability) {
+        unsigned int randomRow = (unsigned int)GetRandomFloat(RNG_STREAM_IGNITION, 5, grid->rows - 5);
+        unsigned int randomCol = (unsigned int)GetRandomFloat(RNG_STREAM_IGNITION, 5, grid->cols - 5);
+        if (GetCellState(grid, randomRow, randomCol) == 0) {
+            IgniteCell(grid, randomRow, randomCol);
         }
     }
+}
 
-    // Update original grid and calculate final section intensity
-    for (unsigned int rowIndex = 0; rowIndex < grid->rows; ++rowIndex) {
-        for (unsigned int colIndex = 0; colIndex < grid->cols; ++colIndex) {
-            grid->cells[rowIndex][colIndex] = newGrid->cells[rowIndex][colIndex];
+void UpdateGridAndCalculateIntensity(Grid *grid, float **sectionIntensity, const Swarm *swarm,
+                                     float* totalBurning, float spreadProbability)
+{
+    unsigned int numSectionsX = grid->numSectionsX;
+    unsigned int numSectionsY = grid->numSectionsY;
+    unsigned int numSections = numSectionsX * numSectionsY;
+    unsigned int sectionWidth = grid->cols / numSectionsX;
+    unsigned int sectionHeight = grid->rows / numSectionsY;
+    float idealBoidCount = (float)swarm->count / numSections;
+
+    // Reset the per-section scratch array for boid counts
+    float *fireIntensities = grid->sectionFire;
+    unsigned int *boidCounts = grid->sectionBoids;
+    memset(boidCounts, 0, numSections * sizeof(unsigned int));
+
+    // Precompute boid counts for all sections
+    for (unsigned int index = 0; index < swarm->count; ++index) {
+        if (!(swarm->flags[index] & BOID_HEADING_HOME)) {
+            unsigned int boidRow = (unsigned int)(swarm->posy[index] / CELL_SIZE);
+            unsigned int boidCol = (unsigned int)(swarm->posx[index] / CELL_SIZE);
+
+            unsigned int sectionX = boidCol / sectionWidth;
+            unsigned int sectionY = boidRow / sectionHeight;
+
+            if (sectionX < numSectionsX && sectionY < numSectionsY) {
+                boidCounts[sectionY * numSectionsX + sectionX]++;
+            }
         }
     }
 
+    // Fire intensity comes from the cells burning at the start of the step, read off the counters
+    for (unsigned int sectionIndex = 0; sectionIndex < numSections; ++sectionIndex) {
+        fireIntensities[sectionIndex] = GetSectionCount(grid, sectionIndex, 1) * 1.0f * grid->fireIntensityBias;
+    }
+    *totalBurning = grid->cellCounts[1];
+
+    PROFILE_BEGIN(PROFILE_FIRE);
+    if (grid->engine == FIRE_ENGINE_SPARSE) {
+        StepSparseFire(grid, spreadProbability);
+    } else if (grid->engine == FIRE_ENGINE_BITSLICED) {
+        StepBitslicedFire(grid, spreadProbability);
+    } else {
+        StepDenseFire(grid, spreadProbability);
+    }
+    PackIdleChunks(grid);
+    PROFILE_END(PROFILE_FIRE);
+
+    // Calculate final section intensity
+    PROFILE_BEGIN(PROFILE_SECTIONS);
     for (unsigned int sectionX = 0; sectionX < numSectionsX; ++sectionX) {
         for (unsigned int sectionY = 0; sectionY < numSectionsY; ++sectionY) {
             unsigned int sectionIndex = sectionY * numSectionsX + sectionX;
 
+            // Sections without fire are penalized by their burnt and extinguished cells
+            if (fireIntensities[sectionIndex] == 0.0f) {
+                uint64_t settled = GetSectionCount(grid, sectionIndex, 2) + GetSectionCount(grid, sectionIndex, 3);
+                fireIntensities[sectionIndex] -= settled * 1.0f * SPREAD_INTENSITY_BIAS_FACTOR;
+            }
+
             unsigned int activeBoidCount = boidCounts[sectionIndex];
 
             // Adjust intensity based on boid distribution
@@ -172,10 +539,349 @@ void UpdateGridAndCalculateIntensity(Grid *grid, float **sectionIntensity, Boid
             sectionIntensity[sectionX][sectionY] = fmaxf(0.0f, fireIntensities[sectionIndex]);  // Ensure non-negative
         }
     }
+    PROFILE_END(PROFILE_SECTIONS);
+}
 
-    // Free allocated memory
-    free(newGrid->cells);
-    free(newGrid);
-    free(fireIntensities);
-    free(boidCounts);
+void InitializeFireField(FireField* field, const Grid* grid)
+{
+    unsigned int windowSize = CHUNK_SIZE + 2 * FIELD_MARGIN;
+
+    field->chunks = (FieldChunk**)calloc((size_t)grid->chunkRows * grid->chunkCols, sizeof(FieldChunk*));
+    field->reach = (unsigned int*)calloc((size_t)grid->chunkRows * grid->chunkCols, sizeof(unsigned int));
+    field->stamp = 0;
+    field->used = NULL;
+    field->usedCount = 0;
+    field->spare = NULL;
+    field->spareCount = 0;
+    field->capacity = 0;
+    field->allocated = 0;
+    field->window = (unsigned char*)malloc(windowSize * windowSize * sizeof(unsigned char));
+    field->nearestRow = (int*)malloc(windowSize * windowSize * sizeof(int));
+    field->envelopeCols = (int*)malloc(windowSize * sizeof(int));
+    field->envelopeZ = (float*)malloc((windowSize + 1) * sizeof(float));
+    if (!field->chunks || !field->reach || !field->window || !field->nearestRow || !field->envelopeCols || !field->envelopeZ) {
+        fprintf(stderr, "Memory allocation failed for fire field\n");
+        exit(1);
+    }
+}
+
+// Field chunk for a slot, recycled from earlier frames when one is spare
+static void AssignFieldChunk(FireField* field, unsigned int chunkIndex)
+{
+    if (field->chunks[chunkIndex]) {
+        return;
+    }
+
+    FieldChunk* fieldChunk;
+    if (field->spareCount > 0) {
+        fieldChunk = field->spare[--field->spareCount];
+    } else {
+        if (field->allocated == field->capacity) {
+            unsigned int newCapacity = field->capacity ? field->capacity * 2 : 16;
+            FieldChunk** used = (FieldChunk**)realloc(field->used, newCapacity * sizeof(FieldChunk*));
+            FieldChunk** spare = (FieldChunk**)realloc(field->spare, newCapacity * sizeof(FieldChunk*));
+            if (!used || !spare) {
+                fprintf(stderr, "Memory allocation failed for fire field\n");
+                exit(1);
+            }
+            field->used = used;
+            field->spare = spare;
+            field->capacity = newCapacity;
+        }
+        fieldChunk = (FieldChunk*)malloc(sizeof(FieldChunk));
+        if (!fieldChunk) {
+            fprintf(stderr, "Memory allocation failed for fire field\n");
+            exit(1);
+        }
+        field->allocated++;
+    }
+
+    fieldChunk->chunkIndex = chunkIndex;
+    field->chunks[chunkIndex] = fieldChunk;
+    field->used[field->usedCount++] = fieldChunk;
+}
+
+// Exact Euclidean feature transform (Felzenszwalb & Huttenlocher) over the chunk and FIELD_MARGIN cells
+// around it: one pass down each column finds the closest burning row, then a lower envelope of parabolas
+// along each row finds the closest column. Any fire within SEARCH_RADIUS of the chunk is inside the window.
+static void ComputeFieldChunk(FireField* field, const Grid* grid, FieldChunk* fieldChunk)
+{
+    unsigned int firstRow = (fieldChunk->chunkIndex / grid->chunkCols) << CHUNK_SHIFT;
+    unsigned int firstCol = (fieldChunk->chunkIndex % grid->chunkCols) << CHUNK_SHIFT;
+    unsigned int lastRow = (firstRow + CHUNK_SIZE < grid->rows) ? firstRow + CHUNK_SIZE : grid->rows;
+    unsigned int lastCol = (firstCol + CHUNK_SIZE < grid->cols) ? firstCol + CHUNK_SIZE : grid->cols;
+    unsigned int windowRow = (firstRow > FIELD_MARGIN) ? firstRow - FIELD_MARGIN : 0;
+    unsigned int windowCol = (firstCol > FIELD_MARGIN) ? firstCol - FIELD_MARGIN : 0;
+    unsigned int windowEndRow = (lastRow + FIELD_MARGIN < grid->rows) ? lastRow + FIELD_MARGIN : grid->rows;
+    unsigned int windowEndCol = (lastCol + FIELD_MARGIN < grid->cols) ? lastCol + FIELD_MARGIN : grid->cols;
+    unsigned int rows = windowEndRow - windowRow;
+    unsigned int cols = windowEndCol - windowCol;
+
+    fieldChunk->windowRow = windowRow;
+    fieldChunk->windowCol = windowCol;
+    fieldChunk->windowCols = cols;
+
+    // Burning cells of the window, a chunk span at a time. Only live chunks can hold fire.
+    for (unsigned int rowIndex = 0; rowIndex < rows; ++rowIndex) {
+        unsigned int gridRow = windowRow + rowIndex;
+        for (unsigned int gridCol = windowCol; gridCol < windowEndCol;) {
+            unsigned int spanEnd = (gridCol | CHUNK_MASK) + 1;
+            if (spanEnd > windowEndCol) spanEnd = windowEndCol;
+
+            unsigned char* burning = &field->window[rowIndex * cols + (gridCol - windowCol)];
+            const CellChunk* chunk = grid->chunks[GetChunkIndex(grid, gridRow, gridCol)].live;
+            if (!chunk || chunk->counts[1] == 0) {
+                memset(burning, 0, spanEnd - gridCol);
+            } else {
+                const Cell* cells = &chunk->cells[GetChunkOffset(gridRow, gridCol)];
+                for (unsigned int offset = 0; offset < spanEnd - gridCol; ++offset) {
+                    burning[offset] = cells[offset].state == 1;
+                }
+            }
+            gridCol = spanEnd;
+        }
+    }
+
+    // Closest burning row in the same column, sweeping down then back up
+    for (unsigned int colIndex = 0; colIndex < cols; ++colIndex) {
+        int lastBurning = -1;
+        for (unsigned int rowIndex = 0; rowIndex < rows; ++rowIndex) {
+            if (field->window[rowIndex * cols + colIndex]) {
+                lastBurning = rowIndex;
+            }
+            field->nearestRow[rowIndex * cols + colIndex] = lastBurning;
+        }
+
+        lastBurning = -1;
+        for (int rowIndex = rows - 1; rowIndex >= 0; --rowIndex) {
+            if (field->window[rowIndex * cols + colIndex]) {
+                lastBurning = rowIndex;
+            }
+            int above = field->nearestRow[rowIndex * cols + colIndex];
+            if (lastBurning >= 0 && (above < 0 || lastBurning - rowIndex < rowIndex - above)) {
+                field->nearestRow[rowIndex * cols + colIndex] = lastBurning;
+            }
+        }
+    }
+
+    // Rows of the chunk itself, the margin rows only feed the column pass
+    for (unsigned int rowIndex = firstRow - windowRow; rowIndex < lastRow - windowRow; ++rowIndex) {
+        int* nearestRow = &field->nearestRow[rowIndex * cols];
+        int* v = field->envelopeCols;
+        float* z = field->envelopeZ;
+        int numParabolas = 0;
+
+        // Build the lower envelope of (col - site)^2 + dy(site)^2 over columns that have a burning cell
+        for (int site = 0; site < (int)cols; ++site) {
+            if (nearestRow[site] < 0) {
+                continue;
+            }
+            float dy = (float)(nearestRow[site] - (int)rowIndex);
+            float height = dy * dy + (float)site * site;
+
+            while (numParabolas > 0) {
+                int prev = v[numParabolas - 1];
+                float prevDy = (float)(nearestRow[prev] - (int)rowIndex);
+                float prevHeight = prevDy * prevDy + (float)prev * prev;
+                float intersection = (height - prevHeight) / (2.0f * (site - prev));
+                if (intersection <= z[numParabolas - 1]) {
+                    numParabolas--;
+                } else {
+                    z[numParabolas] = intersection;
+                    break;
+                }
+            }
+            if (numParabolas == 0) {
+                z[0] = -FLT_MAX;
+            }
+            v[numParabolas++] = site;
+            z[numParabolas] = FLT_MAX;
+        }
+
+        int* nearest = &fieldChunk->nearest[(windowRow + rowIndex - firstRow) * CHUNK_SIZE];
+        if (numParabolas == 0) {
+            for (unsigned int colIndex = firstCol - windowCol; colIndex < lastCol - windowCol; ++colIndex) {
+                nearest[colIndex + windowCol - firstCol] = -1;
+            }
+            continue;
+        }
+
+        int parabola = 0;
+        for (unsigned int colIndex = firstCol - windowCol; colIndex < lastCol - windowCol; ++colIndex) {
+            while (z[parabola + 1] < (float)colIndex) {
+                parabola++;
+            }
+            int site = v[parabola];
+            nearest[colIndex + windowCol - firstCol] = nearestRow[site] * (int)cols + site;
+        }
+    }
+}
+
+// Only chunks that a boid looking for fire sits in, next to a live chunk with fire, get a field. Everywhere
+// else either nothing burns within reach or nobody asks.
+void UpdateFireField(FireField* field, const Grid* grid, const Swarm* swarm)
+{
+    for (unsigned int entry = 0; entry < field->usedCount; ++entry) {
+        field->chunks[field->used[entry]->chunkIndex] = NULL;
+        field->spare[field->spareCount++] = field->used[entry];
+    }
+    field->usedCount = 0;
+    field->stamp++;
+
+    for (unsigned int position = 0; position < grid->liveCount; ++position) {
+        unsigned int chunkIndex = grid->liveChunks[position];
+        if (grid->chunks[chunkIndex].live->counts[1] == 0) {
+            continue;
+        }
+
+        int chunkRow = chunkIndex / grid->chunkCols;
+        int chunkCol = chunkIndex % grid->chunkCols;
+        for (int neighborRow = chunkRow - 1; neighborRow <= chunkRow + 1; ++neighborRow) {
+            for (int neighborCol = chunkCol - 1; neighborCol <= chunkCol + 1; ++neighborCol) {
+                if (neighborRow >= 0 && neighborRow < (int)grid->chunkRows &&
+                    neighborCol >= 0 && neighborCol < (int)grid->chunkCols) {
+                    field->reach[neighborRow * grid->chunkCols + neighborCol] = field->stamp;
+                }
+            }
+        }
+    }
+
+    // FindClosestFire asks the boid's cell and its neighbors toward the boid
+    for (unsigned int index = 0; index < swarm->count; ++index) {
+        if (swarm->flags[index] & (BOID_HEADING_HOME | BOID_TO_BE_REMOVED)) {
+            continue;
+        }
+        int col = (int)floorf(swarm->posx[index] / CELL_SIZE);
+        int row = (int)floorf(swarm->posy[index] / CELL_SIZE);
+        if (col < 0 || row < 0 || col >= (int)grid->cols || row >= (int)grid->rows) {
+            continue;  // Off the grid, FindClosestFire scans instead
+        }
+
+        unsigned int firstChunkRow = ((row > 0) ? row - 1 : 0) >> CHUNK_SHIFT;
+        unsigned int lastChunkRow = ((row + 1 < (int)grid->rows) ? row + 1 : row) >> CHUNK_SHIFT;
+        unsigned int firstChunkCol = ((col > 0) ? col - 1 : 0) >> CHUNK_SHIFT;
+        unsigned int lastChunkCol = ((col + 1 < (int)grid->cols) ? col + 1 : col) >> CHUNK_SHIFT;
+        for (unsigned int chunkRow = firstChunkRow; chunkRow <= lastChunkRow; ++chunkRow) {
+            for (unsigned int chunkCol = firstChunkCol; chunkCol <= lastChunkCol; ++chunkCol) {
+                unsigned int chunkIndex = chunkRow * grid->chunkCols + chunkCol;
+                if (field->reach[chunkIndex] == field->stamp) {
+                    AssignFieldChunk(field, chunkIndex);
+                }
+            }
+        }
+    }
+
+    for (unsigned int entry = 0; entry < field->usedCount; ++entry) {
+        ComputeFieldChunk(field, grid, field->used[entry]);
+    }
+}
+
+// Scan the window of cells within SEARCH_RADIUS, used when the field is stale for this boid
+static bool ScanClosestFire(const Grid* grid, float x, float y, float* fireX, float* fireY, float* fireDistance)
+{
+    int minRow = (int)floorf((y - SEARCH_RADIUS) / CELL_SIZE);
+    int maxRow = (int)floorf((y + SEARCH_RADIUS) / CELL_SIZE);
+    int minCol = (int)floorf((x - SEARCH_RADIUS) / CELL_SIZE);
+    int maxCol = (int)floorf((x + SEARCH_RADIUS) / CELL_SIZE);
+    if (minRow < 0) minRow = 0;
+    if (minCol < 0) minCol = 0;
+    if (maxRow >= (int)grid->rows) maxRow = grid->rows - 1;
+    if (maxCol >= (int)grid->cols) maxCol = grid->cols - 1;
+
+    float closestDistance = SEARCH_RADIUS;
+    bool found = false;
+
+    for (int rowIndex = minRow; rowIndex <= maxRow; ++rowIndex) {
+        for (int colIndex = minCol; colIndex <= maxCol; ++colIndex) {
+            if (GetCellState(grid, rowIndex, colIndex) == 1) {
+                float cellCenterX = colIndex * CELL_SIZE + CELL_SIZE / 2.0f;
+                float cellCenterY = rowIndex * CELL_SIZE + CELL_SIZE / 2.0f;
+                float distance = EuclideanDistance(cellCenterX, cellCenterY, x, y);
+                if (distance < closestDistance) {
+                    closestDistance = distance;
+                    *fireX = cellCenterX;
+                    *fireY = cellCenterY;
+                    found = true;
+                }
+            }
+        }
+    }
+
+    *fireDistance = closestDistance;
+    return found;
+}
+
+bool FindClosestFire(const FireField* field, const Grid* grid, float x, float y,
+                     float* fireX, float* fireY, float* fireDistance)
+{
+    int col = (int)floorf(x / CELL_SIZE);
+    int row = (int)floorf(y / CELL_SIZE);
+    if (col < 0 || row < 0 || col >= (int)grid->cols || row >= (int)grid->rows) {
+        // Boid has drifted off the grid, the field only covers positions on it
+        return ScanClosestFire(grid, x, y, fireX, fireY, fireDistance);
+    }
+
+    // The field is exact for cell centers, so also ask the three cells toward the boid's quadrant
+    int stepCol = (x < col * CELL_SIZE + CELL_SIZE / 2.0f) ? -1 : 1;
+    int stepRow = (y < row * CELL_SIZE + CELL_SIZE / 2.0f) ? -1 : 1;
+    int candidateCols[2] = {col, col + stepCol};
+    int candidateRows[2] = {row, row + stepRow};
+
+    float closestDistance = SEARCH_RADIUS;
+    bool found = false;
+
+    for (unsigned int rowChoice = 0; rowChoice < 2; ++rowChoice) {
+        for (unsigned int colChoice = 0; colChoice < 2; ++colChoice) {
+            int candidateRow = candidateRows[rowChoice];
+            int candidateCol = candidateCols[colChoice];
+            if (candidateRow < 0 || candidateRow >= (int)grid->rows || candidateCol < 0 || candidateCol >= (int)grid->cols) {
+                continue;
+            }
+
+            const FieldChunk* fieldChunk = field->chunks[GetChunkIndex(grid, candidateRow, candidateCol)];
+            int fire = fieldChunk ? fieldChunk->nearest[GetChunkOffset(candidateRow, candidateCol)] : -1;
+            if (fire < 0) {
+                continue;
+            }
+
+            int fireRow = fieldChunk->windowRow + fire / fieldChunk->windowCols;
+            int fireCol = fieldChunk->windowCol + fire % fieldChunk->windowCols;
+            if (GetCellState(grid, fireRow, fireCol) != 1) {
+                // Put out earlier this frame, fall back to scanning around the boid
+                return ScanClosestFire(grid, x, y, fireX, fireY, fireDistance);
+            }
+
+            float cellCenterX = fireCol * CELL_SIZE + CELL_SIZE / 2.0f;
+            float cellCenterY = fireRow * CELL_SIZE + CELL_SIZE / 2.0f;
+            float distance = EuclideanDistance(cellCenterX, cellCenterY, x, y);
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                *fireX = cellCenterX;
+                *fireY = cellCenterY;
+                found = true;
+            }
+        }
+    }
+
+    *fireDistance = closestDistance;
+    return found;
+}
+
+void FreeFireField(FireField* field)
+{
+    for (unsigned int entry = 0; entry < field->usedCount; ++entry) {
+        free(field->used[entry]);
+    }
+    for (unsigned int entry = 0; entry < field->spareCount; ++entry) {
+        free(field->spare[entry]);
+    }
+    free(field->chunks);
+    free(field->reach);
+    free(field->used);
+    free(field->spare);
+    free(field->window);
+    free(field->nearestRow);
+    free(field->envelopeCols);
+    free(field->envelopeZ);
+    *field = (FireField){0};
 }
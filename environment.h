@@ -3,7 +3,7 @@
  * Project:        Boid Swarm Firefight
  * Author:         Peter Ryseck
  * Date Created:   February 8, 2025
- * Last Updated:   February 8, 2025
+ * Last Updated:   October 16, 2026
  *
  * Description:    Logic for wildfire spread and grid operations
  ******************************************************/
@@ -13,6 +13,9 @@
 
 #include "constants.h"
 #include "boid.h"
+#include "threadpool.h"
+#include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 typedef struct {
@@ -21,23 +24,206 @@ typedef struct {
 } HomeTarget;
 
 typedef struct {
-    float xval;
-    float yval;
-    unsigned int state;  // 0: unburnt, 1: burning, 2: burnt, 3: extinguished
-    unsigned int timer;
+    unsigned char state;  // 0: unburnt, 1: burning, 2: burnt, 3: extinguished
+    unsigned char timer;  // Dense engine: steps left burning, other engines: low byte of the burnout tick
 } Cell;
 
+static_assert(BURNING_DURATION < 256, "Cell timer is one byte");
+
+typedef enum {
+    FIRE_ENGINE_DENSE,     // Reference engine, visits every cell of the grid each step
+    FIRE_ENGINE_SPARSE,    // Only visits the burning front, burnout scheduled on a timer wheel
+    FIRE_ENGINE_BITSLICED  // Cell states as bitplanes, spreads 64 cells per word operation
+} FireEngine;
+
+typedef struct {
+    uint64_t* cells;  // Flat cell indices, row * cols + col
+    unsigned int count;
+    unsigned int capacity;
+} CellList;
+
+#define BURNOUT_WHEEL_SIZE (BURNING_DURATION + 1)
+#define CELL_UNCLAIMED 0xFFFFFFFFu
+#define FIRE_TILE_ROWS 16  // Grid rows per parallel fire work item
+#define CELL_STATE_COUNT 4 // Unburnt, burning, burnt, extinguished
+#define DIRTY_ROW_RENDER 0x01 // Row not yet uploaded by the renderer
+#define DIRTY_ROW_RECORD 0x02 // Row not yet sent to the recorder
+#define DIRTY_ROW_PUBLISH 0x04 // Row not yet copied to shared memory
+#define DIRTY_ROW_ALL (DIRTY_ROW_RENDER | DIRTY_ROW_RECORD | DIRTY_ROW_PUBLISH)
+
+#define CHUNK_SHIFT 7
+#define CHUNK_SIZE (1u << CHUNK_SHIFT)         // Cells along each side of a storage chunk
+#define CHUNK_MASK (CHUNK_SIZE - 1)
+#define CHUNK_CELLS (CHUNK_SIZE * CHUNK_SIZE)
+#define FULL_GRID_MAX_CELLS (64ull << 20)      // Largest world for the dense and bit-sliced engines, whose memory grows with the whole world
+#define CHUNK_IDLE_TICKS (2 * BURNING_DURATION) // Steps without a state change before a chunk without fire is packed
+#define FIELD_MARGIN ((SEARCH_RADIUS + CELL_SIZE - 1) / CELL_SIZE + 2) // Reach of the fire field around a chunk, in cells
+
+static_assert(CHUNK_SIZE % FIRE_TILE_ROWS == 0, "Fire tiles never straddle two rows of chunks");
+static_assert(FIELD_MARGIN <= CHUNK_SIZE, "Fire field reach stays within the neighboring chunks");
+
+// Full storage for a chunk that has fire or changed recently
 typedef struct {
-    Cell** cells;
+    Cell* cells;                  // CHUNK_CELLS cells, row-major within the chunk
+    Cell* nextCells;              // Dense engine only, written by the step and swapped with cells
+    unsigned int* claims;         // Per cell, lowest boid index trying to put it out this frame
+    unsigned char* listed;        // Per cell, 1 while the cell is in the burning list (sparse engine)
+    unsigned int counts[CELL_STATE_COUNT]; // Cells in each state, cells past the edge of the world stay unburnt
+    unsigned int listedCount;
+    unsigned int lastChange;      // Tick of the last state change
+    unsigned int livePosition;    // Index in Grid.liveChunks
+} CellChunk;
+
+// A chunk is live, packed at 2 bits per cell once it has been quiet for a while, or uniform (every cell in
+// one state, nothing allocated). Untouched chunks are uniformly unburnt.
+typedef struct {
+    CellChunk* live;
+    unsigned char* packed;
+    unsigned char uniform;
+} ChunkSlot;
+
+typedef struct {
+    CellList burning;                        // Cells that may be burning, stale entries are dropped each step
+    CellList wheel[BURNOUT_WHEEL_SIZE];      // Cells burning out at tick, in slot tick % BURNOUT_WHEEL_SIZE
+} FireFront;
+
+// One bit per cell, bit b of word w in a row is column w * 64 + b
+typedef struct {
+    uint64_t* burning;
+    uint64_t* unburnt;
+    uint64_t* ignited;                       // Scratch: cells set alight during the current step
+    uint64_t* burnout[BURNOUT_WHEEL_SIZE];   // Cells burning out at tick, in plane tick % BURNOUT_WHEEL_SIZE
+    unsigned int wordsPerRow;
+} FireBitplanes;
+
+typedef struct {
+    ChunkSlot* chunks;             // chunkRows * chunkCols slots, row-major
+    unsigned int chunkRows;
+    unsigned int chunkCols;
+    unsigned int* liveChunks;      // Slot indices of the live chunks
+    unsigned int liveCount;
+    unsigned int liveCapacity;
+    unsigned int packedCount;      // Chunks stored at 2 bits per cell
     unsigned int rows;
     unsigned int cols;
+    FireEngine engine;
+    unsigned int tick;             // Index of the last started step
+    uint64_t cellsScanned;         // Cells the fire engine has looked at, for cell-update rates
+    unsigned int numSectionsX;
+    unsigned int numSectionsY;
+    float ignitionProbability;     // Chance of a random ignition per step, RANDOM_IGNITION_PROB by default
+    float fireIntensityBias;       // Section intensity per burning cell, FIRE_INTENSITY_BIAS_FACTOR by default
+    uint64_t* sectionCounts;       // Cells in each state per section, sectionIndex * CELL_STATE_COUNT + state
+    uint64_t cellCounts[CELL_STATE_COUNT]; // Cells in each state over the whole grid
+    float* sectionFire;            // Scratch: fire intensity per section for the current step
+    unsigned int* sectionBoids;    // Scratch: boids not heading home per section for the current step
+    FireFront front;               // Burning front (sparse engine)
+    FireBitplanes planes;          // Bitplanes (bit-sliced engine)
+    int* tileCounts;               // Scratch: change in cells per state for each tile and section (dense engine)
+    ThreadPool* pool;              // Optional, the dense and bit-sliced engines run their tiles on it
+    unsigned char* dirtyRows;      // Per row, DIRTY_ROW_ALL when a cell in it changes state, each reader clears its own bit
 } Grid;
 
-extern Cell grid[GRID_HEIGHT][GRID_WIDTH];
+// Closest burning cell for every cell of one chunk, searched within FIELD_MARGIN cells around the chunk
+typedef struct {
+    int nearest[CHUNK_CELLS];  // Index into the window (row * windowCols + col), -1 if no fire in the window
+    unsigned int windowRow;    // Top left cell of the window
+    unsigned int windowCol;
+    unsigned int windowCols;
+    unsigned int chunkIndex;   // Slot this field currently covers
+} FieldChunk;
+
+typedef struct {
+    FieldChunk** chunks;       // Per chunk slot, NULL where no fire is in reach or no boid is looking
+    unsigned int* reach;       // Per chunk slot, stamp of the last update that found fire within one chunk
+    unsigned int stamp;
+    FieldChunk** used;         // Chunks holding a field this frame
+    unsigned int usedCount;
+    FieldChunk** spare;        // Recycled from earlier frames
+    unsigned int spareCount;
+    unsigned int capacity;     // Room in used and spare
+    unsigned int allocated;    // Field chunks in existence, used or spare
+    unsigned char* window;     // Scratch: 1 where the window has a burning cell
+    int* nearestRow;           // Scratch: closest burning row within the same window column
+    int* envelopeCols;         // Scratch: parabola sites of the lower envelope for one row
+    float* envelopeZ;          // Scratch: boundaries between envelope parabolas
+} FireField;
+
+// Any thread may mark rows during a step, readers clear their bits between steps
+static inline void MarkRowDirty(Grid* grid, unsigned int row) {
+    __atomic_store_n(&grid->dirtyRows[row], DIRTY_ROW_ALL, __ATOMIC_RELAXED);
+}
+
+static inline unsigned int GetChunkIndex(const Grid* grid, unsigned int row, unsigned int col) {
+    return (row >> CHUNK_SHIFT) * grid->chunkCols + (col >> CHUNK_SHIFT);
+}
+
+static inline unsigned int GetChunkOffset(unsigned int row, unsigned int col) {
+    return (row & CHUNK_MASK) * CHUNK_SIZE + (col & CHUNK_MASK);
+}
+
+// Reads never allocate, packed and uniform chunks are decoded in place
+static inline unsigned char GetCellState(const Grid* grid, unsigned int row, unsigned int col) {
+    const ChunkSlot* slot = &grid->chunks[GetChunkIndex(grid, row, col)];
+    unsigned int offset = GetChunkOffset(row, col);
+    if (slot->live) {
+        return slot->live->cells[offset].state;
+    }
+    if (slot->packed) {
+        return (slot->packed[offset / 4] >> ((offset % 4) * 2)) & 3;
+    }
+    return slot->uniform;
+}
+
+// Chunked cell storage, chunks.c
+void InitializeChunks(Grid* grid);
+CellChunk* MakeChunkLive(Grid* grid, unsigned int chunkIndex);
+void PackIdleChunks(Grid* grid);
+void FreeChunks(Grid* grid);
+void InitializeViewGrid(Grid* grid, unsigned int cols, unsigned int rows);
+void FreeViewGrid(Grid* grid);
+
+// Writable cell, the chunk is made live first. Cells that are burning are always in live chunks, so
+// pool threads only ever reach the fast path.
+static inline CellChunk* GetLiveChunk(Grid* grid, unsigned int row, unsigned int col) {
+    unsigned int chunkIndex = GetChunkIndex(grid, row, col);
+    CellChunk* chunk = grid->chunks[chunkIndex].live;
+    return chunk ? chunk : MakeChunkLive(grid, chunkIndex);
+}
+
+static inline Cell* GetCell(Grid* grid, unsigned int row, unsigned int col) {
+    return &GetLiveChunk(grid, row, col)->cells[GetChunkOffset(row, col)];
+}
+
+// Only the sparse engine runs worlds over FULL_GRID_MAX_CELLS, front ends check before InitializeGrid
+bool IsWorldSizeSupported(FireEngine engine, unsigned int cols, unsigned int rows);
+void InitializeGrid(Grid* grid, FireEngine engine, unsigned int cols, unsigned int rows,
+                    unsigned int numSectionsX, unsigned int numSectionsY);
+void UpdateGridAndCalculateIntensity(Grid* grid, float** sectionIntensity, const Swarm* swarm,
+                                     float* totalBurning, float spreadProbability);
+uint64_t GetSectionCount(const Grid* grid, unsigned int sectionIndex, unsigned char state);
+void SetCellState(Grid* grid, unsigned int row, unsigned int col, unsigned char state);
+void IgniteCell(Grid* grid, unsigned int row, unsigned int col);
+void ExtinguishCell(Grid* grid, unsigned int row, unsigned int col);
+void ClaimCell(Grid* grid, unsigned int row, unsigned int col, unsigned int claimant);
+bool HoldsClaim(const Grid* grid, unsigned int row, unsigned int col, unsigned int claimant);
+void ReleaseClaim(Grid* grid, unsigned int row, unsigned int col);
+unsigned int GetSectionIndex(const Grid* grid, unsigned int row, unsigned int col);
+unsigned int GetBurnoutTick(const Grid* grid, const Cell* cell);
+void FreeGrid(Grid* grid);
+
+// Bit-sliced engine, bitfire.c
+void InitializeFireBitplanes(Grid* grid);
+void StepBitslicedFire(Grid* grid, float spreadProbability);
+void SetBitplaneBurning(Grid* grid, unsigned int row, unsigned int col, unsigned int burnoutTick);
+void ClearBitplaneBurning(Grid* grid, unsigned int row, unsigned int col, unsigned int burnoutTick);
+void FreeFireBitplanes(Grid* grid);
 
-void InitializeGrid(Grid* grid);
-void UpdateGridAndCalculateIntensity(Grid* grid, float** sectionIntensity, Boid* boids, unsigned int numBoids,
-                                     unsigned int numSectionsX, unsigned int numSectionsY, float* totalBurning, float spreadProbability);
+void InitializeFireField(FireField* field, const Grid* grid);
+void UpdateFireField(FireField* field, const Grid* grid, const Swarm* swarm);
+bool FindClosestFire(const FireField* field, const Grid* grid, float x, float y,
+                     float* fireX, float* fireY, float* fireDistance);
+void FreeFireField(FireField* field);
 
 typedef struct {
     unsigned int row;
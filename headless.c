@@ -0,0 +1,255 @@
+/******************************************************
+ * File:           headless.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Runs the simulation without a display and prints summary stats
+ * Compile: gcc -O3 -march=native -o boid-headless headless.c simulation.c boid.c utils.c environment.c bitfire.c spatial_hash.c kernels.c rng.c threadpool.c section_pyramid.c chunks.c checkpoint.c recorder.c publisher.c profile.c -lm -lpthread -lz
+ *          add -DBOID_PROFILE for per-zone timings, work counters and --trace
+ * Usage:   ./boid-headless [--load file] [--save file] [--record file] [--trace file] [--publish name] [frames] [seed] [dense|sparse|bitsliced] [threads] [cols] [rows]
+ ******************************************************/
+
+#include "simulation.h"
+#include "checkpoint.h"
+#include "recorder.h"
+#include "publisher.h"
+#include "profile.h"
+#include "kernels.h"
+#include "utils.h"
+#include "constants.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char* engineNames[] = {"dense", "sparse", "bitsliced"};
+
+int main(int argc, char* argv[])
+{
+    // File options may appear anywhere, the rest are positional
+    const char* loadPath = NULL;
+    const char* savePath = NULL;
+    const char* recordPath = NULL;
+    const char* tracePath = NULL;
+    const char* publishName = NULL;
+    int positional = 1;
+    for (int arg = 1; arg < argc; arg++)
+    {
+        if (strcmp(argv[arg], "--load") == 0 && arg + 1 < argc)
+        {
+            loadPath = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--save") == 0 && arg + 1 < argc)
+        {
+            savePath = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--record") == 0 && arg + 1 < argc)
+        {
+            recordPath = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--trace") == 0 && arg + 1 < argc)
+        {
+            tracePath = argv[++arg];
+        }
+        else if (strcmp(argv[arg], "--publish") == 0 && arg + 1 < argc)
+        {
+            publishName = argv[++arg];
+        }
+        else
+        {
+            argv[positional++] = argv[arg];
+        }
+    }
+    argc = positional;
+    if (tracePath && !PROFILE_ENABLED)
+    {
+        fprintf(stderr, "--trace needs a build with -DBOID_PROFILE\n");
+        return 1;
+    }
+
+    unsigned int frames = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 0) : 1000;
+    uint64_t seed = (argc > 2) ? strtoull(argv[2], NULL, 0) : (uint64_t)time(NULL);
+    FireEngine engine = FIRE_ENGINE;
+
+    if (argc > 3)
+    {
+        unsigned int index = 0;
+        while (index < 3 && strcmp(argv[3], engineNames[index]) != 0)
+        {
+            index++;
+        }
+        if (index == 3)
+        {
+            fprintf(stderr, "Unknown fire engine '%s', expected dense, sparse or bitsliced\n", argv[3]);
+            return 1;
+        }
+        engine = (FireEngine)index;
+    }
+
+    // World size in cells, defaults to the screen-sized grid
+    unsigned int cols = (argc > 5) ? (unsigned int)strtoul(argv[5], NULL, 0) : GRID_WIDTH;
+    uint64_t aspectRows = (uint64_t)cols * GRID_HEIGHT / GRID_WIDTH;
+    if (argc <= 6 && aspectRows > UINT32_MAX)
+    {
+        fprintf(stderr, "%u columns at the screen aspect ratio is over %u rows, give the rows\n", cols, UINT32_MAX);
+        return 1;
+    }
+    unsigned int rows = (argc > 6) ? (unsigned int)strtoul(argv[6], NULL, 0) : (unsigned int)aspectRows;
+    if (cols < 16 || rows < 16)
+    {
+        fprintf(stderr, "World must be at least 16 by 16 cells\n");
+        return 1;
+    }
+    if (!loadPath && !IsWorldSizeSupported(engine, cols, rows))
+    {
+        fprintf(stderr, "World of %ux%u cells is too large for the %s engine, use sparse\n", cols, rows, engineNames[engine]);
+        return 1;
+    }
+
+    Simulation sim;
+    if (loadPath)
+    {
+        // The engine and world size come from the checkpoint, a given seed forks the run onto new streams
+        if (!LoadCheckpoint(&sim, loadPath))
+        {
+            return 1;
+        }
+        engine = sim.grid.engine;
+        cols = sim.grid.cols;
+        rows = sim.grid.rows;
+        if (argc > 2)
+        {
+            sim.seed = seed;
+            SeedRandom(seed);
+        }
+        seed = sim.seed;
+    }
+    else
+    {
+        InitializeSimulation(&sim, seed, engine, cols, rows);
+
+        // Seed one fire in the middle of the map, the viewer relies on clicks and random ignition for this
+        IgniteCell(&sim.grid, rows / 2, cols / 2);
+    }
+    if (argc > 4)
+    {
+        SetSimulationThreads(&sim, (unsigned int)strtoul(argv[4], NULL, 0));
+    }
+
+    Recorder recorder;
+    if (recordPath)
+    {
+        if (!OpenRecorder(&recorder, &sim, recordPath))
+        {
+            FreeSimulation(&sim);
+            return 1;
+        }
+        RecordFrame(&recorder, &sim);  // Starting state
+    }
+
+    Publisher publisher;
+    if (publishName)
+    {
+        if (!OpenPublisher(&publisher, &sim, publishName))
+        {
+            if (recordPath)
+            {
+                CloseRecorder(&recorder);
+            }
+            FreeSimulation(&sim);
+            return 1;
+        }
+        PublishFrame(&publisher, &sim);
+    }
+
+    if (tracePath)
+    {
+        StartProfileTrace();
+    }
+
+    float peakBurning = 0;
+    unsigned int peakBoids = 0;
+    double startTime = GetTimeSeconds();
+    for (unsigned int frame = 0; frame < frames; frame++)
+    {
+        StepSimulation(&sim, 1);
+        if (recordPath)
+        {
+            RecordFrame(&recorder, &sim);
+        }
+        if (publishName)
+        {
+            PublishFrame(&publisher, &sim);
+        }
+        if (sim.totalBurning > peakBurning) peakBurning = sim.totalBurning;
+        if (sim.swarm.count > peakBoids) peakBoids = sim.swarm.count;
+    }
+    double elapsed = GetTimeSeconds() - startTime;
+    if (publishName)
+    {
+        ClosePublisher(&publisher);
+    }
+
+    // Written after the timing, the loop only pays for handing frames to the writer
+    if (recordPath && !CloseRecorder(&recorder))
+    {
+        FreeSimulation(&sim);
+        return 1;
+    }
+
+    if (tracePath && !WriteProfileTrace(tracePath))
+    {
+        FreeSimulation(&sim);
+        return 1;
+    }
+
+    if (savePath && !SaveCheckpoint(&sim, savePath))
+    {
+        FreeSimulation(&sim);
+        return 1;
+    }
+
+    SimulationStats stats;
+    GetSimulationStats(&sim, &stats);
+
+    printf("seed %llu\n", (unsigned long long)seed);
+    printf("engine %s\n", engineNames[engine]);
+    printf("kernels %s\n", GetKernelName());
+    printf("threads %u\n", sim.pool.threadCount);
+    printf("frames %llu\n", sim.frame);
+    printf("seconds %.3f\n", elapsed);
+    printf("frames_per_second %.1f\n", elapsed > 0 ? frames / elapsed : 0.0);
+    printf("world %ux%u\n", cols, rows);
+    printf("cells_unburnt %llu\n", stats.unburnt);
+    printf("cells_burning %llu\n", stats.burning);
+    printf("cells_burnt %llu\n", stats.burnt);
+    printf("cells_extinguished %llu\n", stats.extinguished);
+    printf("live_chunks %u\n", stats.liveChunks);
+    printf("packed_chunks %u\n", stats.packedChunks);
+    printf("peak_burning %.0f\n", peakBurning);
+    printf("boids %u\n", stats.boids);
+    printf("boids_heading_home %u\n", stats.boidsHeadingHome);
+    printf("peak_boids %u\n", peakBoids);
+    if (recordPath)
+    {
+        printf("recorder_dropped_frames %llu\n", recorder.droppedFrames);
+    }
+    if (PROFILE_ENABLED && frames > 0)
+    {
+        ProfileTotals totals;
+        ReadProfileTotals(&totals);
+        for (unsigned int zone = PROFILE_STEP; zone < PROFILE_RENDER_GRID; zone++)
+        {
+            printf("profile_%s_ms %.3f\n", GetProfileZoneName(zone), totals.nanoseconds[zone] / 1e6 / frames);
+        }
+        for (unsigned int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++)
+        {
+            printf("profile_%s_per_step %.0f\n", GetProfileCounterName(counter), (double)totals.counters[counter] / frames);
+        }
+    }
+
+    FreeSimulation(&sim);
+    return 0;
+}
@@ -0,0 +1,321 @@
+/******************************************************
+ * File:           kernels.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Vectorized steering kernels over swarm arrays
+ ******************************************************/
+
+#include "kernels.h"
+#include "constants.h"
+#include "utils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// Each kernel is written once against the small vector layer below. AVX2 runs 8 boids per
+// instruction, AArch64 NEON runs 4, and the scalar fallback runs the same code one boid at a time.
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+#define SIMD_WIDTH 8
+#define KERNEL_NAME "avx2"
+typedef __m256 vfloat;
+typedef __m256 vmask;
+
+static inline vfloat VLoad(const float* p) { return _mm256_loadu_ps(p); }
+static inline void VStore(float* p, vfloat v) { _mm256_storeu_ps(p, v); }
+static inline vfloat VSet(float x) { return _mm256_set1_ps(x); }
+static inline vfloat VIota(void) { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+static inline vfloat VAdd(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+static inline vfloat VSub(vfloat a, vfloat b) { return _mm256_sub_ps(a, b); }
+static inline vfloat VMul(vfloat a, vfloat b) { return _mm256_mul_ps(a, b); }
+static inline vfloat VDiv(vfloat a, vfloat b) { return _mm256_div_ps(a, b); }
+static inline vfloat VSqrt(vfloat a) { return _mm256_sqrt_ps(a); }
+static inline vfloat VMax(vfloat a, vfloat b) { return _mm256_max_ps(a, b); }
+static inline vmask VLess(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline vmask VGreater(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline vmask VNotEqual(vfloat a, vfloat b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_OQ); }
+static inline vmask VAnd(vmask a, vmask b) { return _mm256_and_ps(a, b); }
+static inline vmask VOr(vmask a, vmask b) { return _mm256_or_ps(a, b); }
+static inline vfloat VSelect(vmask m, vfloat a, vfloat b) { return _mm256_blendv_ps(b, a, m); }
+static inline float VSum(vfloat v)
+{
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_movehdup_ps(half));
+    return _mm_cvtss_f32(half);
+}
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+
+#define SIMD_WIDTH 4
+#define KERNEL_NAME "neon"
+typedef float32x4_t vfloat;
+typedef uint32x4_t vmask;
+
+static inline vfloat VLoad(const float* p) { return vld1q_f32(p); }
+static inline void VStore(float* p, vfloat v) { vst1q_f32(p, v); }
+static inline vfloat VSet(float x) { return vdupq_n_f32(x); }
+static inline vfloat VIota(void) { const float lanes[4] = {0, 1, 2, 3}; return vld1q_f32(lanes); }
+static inline vfloat VAdd(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+static inline vfloat VSub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+static inline vfloat VMul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+static inline vfloat VDiv(vfloat a, vfloat b) { return vdivq_f32(a, b); }
+static inline vfloat VSqrt(vfloat a) { return vsqrtq_f32(a); }
+static inline vfloat VMax(vfloat a, vfloat b) { return vmaxq_f32(a, b); }
+static inline vmask VLess(vfloat a, vfloat b) { return vcltq_f32(a, b); }
+static inline vmask VGreater(vfloat a, vfloat b) { return vcgtq_f32(a, b); }
+static inline vmask VNotEqual(vfloat a, vfloat b) { return vmvnq_u32(vceqq_f32(a, b)); }
+static inline vmask VAnd(vmask a, vmask b) { return vandq_u32(a, b); }
+static inline vmask VOr(vmask a, vmask b) { return vorrq_u32(a, b); }
+static inline vfloat VSelect(vmask m, vfloat a, vfloat b) { return vbslq_f32(m, a, b); }
+static inline float VSum(vfloat v) { return vaddvq_f32(v); }
+
+#else
+
+#define SIMD_WIDTH 1
+#define KERNEL_NAME "scalar"
+typedef float vfloat;
+typedef bool vmask;
+
+static inline vfloat VLoad(const float* p) { return *p; }
+static inline void VStore(float* p, vfloat v) { *p = v; }
+static inline vfloat VSet(float x) { return x; }
+static inline vfloat VIota(void) { return 0.0f; }
+static inline vfloat VAdd(vfloat a, vfloat b) { return a + b; }
+static inline vfloat VSub(vfloat a, vfloat b) { return a - b; }
+static inline vfloat VMul(vfloat a, vfloat b) { return a * b; }
+static inline vfloat VDiv(vfloat a, vfloat b) { return a / b; }
+static inline vfloat VSqrt(vfloat a) { return sqrtf(a); }
+static inline vfloat VMax(vfloat a, vfloat b) { return fmaxf(a, b); }
+static inline vmask VLess(vfloat a, vfloat b) { return a < b; }
+static inline vmask VGreater(vfloat a, vfloat b) { return a > b; }
+static inline vmask VNotEqual(vfloat a, vfloat b) { return a != b; }
+static inline vmask VAnd(vmask a, vmask b) { return a && b; }
+static inline vmask VOr(vmask a, vmask b) { return a || b; }
+static inline vfloat VSelect(vmask m, vfloat a, vfloat b) { return m ? a : b; }
+static inline float VSum(vfloat v) { return v; }
+
+#endif
+
+#if BOID_BATCH % SIMD_WIDTH != 0
+#error "BOID_BATCH must be a multiple of the SIMD width"
+#endif
+
+const char* GetKernelName(void)
+{
+    return KERNEL_NAME;
+}
+
+// Lane-wise LimitVector: rescale (x, y) to min or max when its magnitude is outside [min, max]
+static inline void VLimit(vfloat* x, vfloat* y, vfloat min, vfloat max)
+{
+    vfloat zero = VSet(0.0f);
+    vfloat mag = VSqrt(VAdd(VMul(*x, *x), VMul(*y, *y)));
+    vmask nonZero = VGreater(mag, zero);
+    vmask overMax = VAnd(VGreater(mag, max), nonZero);
+    vmask underMin = VAnd(VLess(mag, min), nonZero);
+    vfloat target = VSelect(overMax, max, min);
+    vmask limited = VOr(overMax, underMin);
+
+    // Zero magnitude lanes divide by zero here, they are never selected
+    *x = VSelect(limited, VMul(VDiv(*x, mag), target), *x);
+    *y = VSelect(limited, VMul(VDiv(*y, mag), target), *y);
+}
+
+static void ReserveNeighborSums(NeighborSums* sums, unsigned int capacity)
+{
+    free(sums->sumx);
+    free(sums->sumy);
+    free(sums->total);
+    sums->sumx = (float*)AllocateAligned(capacity, sizeof(float));
+    sums->sumy = (float*)AllocateAligned(capacity, sizeof(float));
+    sums->total = (float*)AllocateAligned(capacity, sizeof(float));
+}
+
+void ReserveFlockSums(FlockSums* sums, unsigned int capacity)
+{
+    if (capacity <= sums->capacity)
+    {
+        return;
+    }
+
+    // Scratch only, nothing to preserve across a resize
+    ReserveNeighborSums(&sums->alignment, capacity);
+    ReserveNeighborSums(&sums->cohesion, capacity);
+    ReserveNeighborSums(&sums->separation, capacity);
+    sums->capacity = capacity;
+}
+
+void FreeFlockSums(FlockSums* sums)
+{
+    NeighborSums* all[3] = {&sums->alignment, &sums->cohesion, &sums->separation};
+    for (unsigned int index = 0; index < 3; index++)
+    {
+        free(all[index]->sumx);
+        free(all[index]->sumy);
+        free(all[index]->total);
+        all[index]->sumx = NULL;
+        all[index]->sumy = NULL;
+        all[index]->total = NULL;
+    }
+    sums->capacity = 0;
+}
+
+void AccumulateNeighbors(const float* posx, const float* posy, const float* velx, const float* vely,
+                         unsigned int start, unsigned int end, unsigned int skipSlot,
+                         float x, float y, FlockSums* sums, unsigned int boid)
+{
+    vfloat boidX = VSet(x);
+    vfloat boidY = VSet(y);
+    vfloat zero = VSet(0.0f);
+    vfloat one = VSet(1.0f);
+    vfloat alignRadius = VSet(ALIGNMENT_RADIUS);
+    vfloat cohesionRadius = VSet(COHESION_RADIUS);
+    vfloat separationRadius = VSet(SEPARATION_RADIUS);
+    vfloat lanes = VIota();
+
+    vfloat alignX = zero, alignY = zero, alignTotal = zero;
+    vfloat cohesionX = zero, cohesionY = zero, cohesionTotal = zero;
+    vfloat separationX = zero, separationY = zero, separationTotal = zero;
+
+    // Slot arrays are padded by BOID_BATCH, so the last batch may read past end and mask it off. The masks
+    // compare lane numbers within the batch, which stay exact in float where slot numbers past 2^24 would not.
+    for (unsigned int slot = start; slot < end; slot += SIMD_WIDTH)
+    {
+        unsigned int remaining = end - slot;
+        unsigned int skipLane = skipSlot - slot;  // Wraps past SIMD_WIDTH when the skipped slot is elsewhere
+        vfloat laneEnd = VSet((float)(remaining < SIMD_WIDTH ? remaining : SIMD_WIDTH));
+        vfloat skip = VSet(skipLane < SIMD_WIDTH ? (float)skipLane : -1.0f);
+        vmask valid = VAnd(VLess(lanes, laneEnd), VNotEqual(lanes, skip));
+
+        vfloat otherX = VLoad(&posx[slot]);
+        vfloat otherY = VLoad(&posy[slot]);
+        vfloat diffX = VSub(otherX, boidX);
+        vfloat diffY = VSub(otherY, boidY);
+        vfloat dist = VSqrt(VAdd(VMul(diffX, diffX), VMul(diffY, diffY)));
+
+        vmask inAlign = VAnd(valid, VLess(dist, alignRadius));
+        alignX = VAdd(alignX, VSelect(inAlign, VLoad(&velx[slot]), zero));
+        alignY = VAdd(alignY, VSelect(inAlign, VLoad(&vely[slot]), zero));
+        alignTotal = VAdd(alignTotal, VSelect(inAlign, one, zero));
+
+        vmask inCohesion = VAnd(valid, VLess(dist, cohesionRadius));
+        cohesionX = VAdd(cohesionX, VSelect(inCohesion, otherX, zero));
+        cohesionY = VAdd(cohesionY, VSelect(inCohesion, otherY, zero));
+        cohesionTotal = VAdd(cohesionTotal, VSelect(inCohesion, one, zero));
+
+        vmask inSeparation = VAnd(VAnd(valid, VLess(dist, separationRadius)), VNotEqual(dist, zero));
+        separationX = VAdd(separationX, VSelect(inSeparation, VDiv(VSub(zero, diffX), dist), zero));
+        separationY = VAdd(separationY, VSelect(inSeparation, VDiv(VSub(zero, diffY), dist), zero));
+        separationTotal = VAdd(separationTotal, VSelect(inSeparation, one, zero));
+    }
+
+    sums->alignment.sumx[boid] += VSum(alignX);
+    sums->alignment.sumy[boid] += VSum(alignY);
+    sums->alignment.total[boid] += VSum(alignTotal);
+    sums->cohesion.sumx[boid] += VSum(cohesionX);
+    sums->cohesion.sumy[boid] += VSum(cohesionY);
+    sums->cohesion.total[boid] += VSum(cohesionTotal);
+    sums->separation.sumx[boid] += VSum(separationX);
+    sums->separation.sumy[boid] += VSum(separationY);
+    sums->separation.total[boid] += VSum(separationTotal);
+}
+
+void ApplySteeringSums(Swarm* swarm, const NeighborSums* sums, float steerForce, bool normalizeFlag, bool subtractPosFlag)
+{
+    vfloat zero = VSet(0.0f);
+    vfloat one = VSet(1.0f);
+    vfloat minSpeed = VSet(MIN_SPEED);
+    vfloat maxSpeed = VSet(MAX_SPEED);
+    vfloat maxForce = VSet(steerForce);
+
+    // Runs whole batches, padding slots past count hold scratch values nobody reads
+    for (unsigned int index = 0; index < swarm->count; index += SIMD_WIDTH)
+    {
+        vfloat total = VLoad(&sums->total[index]);
+        vmask hasNeighbors = VGreater(total, zero);
+        vfloat divisor = VMax(total, one);
+
+        vfloat steerX = VDiv(VLoad(&sums->sumx[index]), divisor);
+        vfloat steerY = VDiv(VLoad(&sums->sumy[index]), divisor);
+
+        if (subtractPosFlag)
+        {
+            steerX = VSub(steerX, VLoad(&swarm->posx[index]));
+            steerY = VSub(steerY, VLoad(&swarm->posy[index]));
+        }
+
+        if (normalizeFlag)
+        {
+            VLimit(&steerX, &steerY, minSpeed, maxSpeed);
+        }
+
+        vfloat velX = VLoad(&swarm->velx[index]);
+        vfloat velY = VLoad(&swarm->vely[index]);
+        steerX = VSub(steerX, velX);
+        steerY = VSub(steerY, velY);
+        VLimit(&steerX, &steerY, zero, maxForce);
+
+        vfloat newVelX = VAdd(velX, steerX);
+        vfloat newVelY = VAdd(velY, steerY);
+        VLimit(&newVelX, &newVelY, minSpeed, maxSpeed);
+
+        VStore(&swarm->velx[index], VSelect(hasNeighbors, newVelX, velX));
+        VStore(&swarm->vely[index], VSelect(hasNeighbors, newVelY, velY));
+    }
+}
+
+// Keeps boids inside a width by height pixel world
+void ApplyEdges(Swarm* swarm, float width, float height)
+{
+    vfloat zero = VSet(0.0f);
+    vfloat maxSpeed = VSet(MAX_SPEED);
+    vfloat minusMaxSpeed = VSet(-MAX_SPEED);
+    vfloat maxWallForce = VSet(MAX_WALL_FORCE);
+    vfloat lowMargin = VSet(WALL_MARGIN);
+    vfloat highMarginX = VSet(width - WALL_MARGIN);
+    vfloat highMarginY = VSet(height - WALL_MARGIN);
+
+    for (unsigned int index = 0; index < swarm->count; index += SIMD_WIDTH)
+    {
+        vfloat posX = VLoad(&swarm->posx[index]);
+        vfloat posY = VLoad(&swarm->posy[index]);
+        vfloat velX = VLoad(&swarm->velx[index]);
+        vfloat velY = VLoad(&swarm->vely[index]);
+
+        // Push back in along each axis the boid is close to leaving on
+        vfloat edgeX = VSelect(VLess(posX, lowMargin), maxSpeed, VSelect(VGreater(posX, highMarginX), minusMaxSpeed, zero));
+        vfloat edgeY = VSelect(VLess(posY, lowMargin), maxSpeed, VSelect(VGreater(posY, highMarginY), minusMaxSpeed, zero));
+
+        vfloat mag = VSqrt(VAdd(VMul(edgeX, edgeX), VMul(edgeY, edgeY)));
+        vmask nearWall = VGreater(mag, zero);
+
+        vfloat forceX = VSub(VMul(VDiv(edgeX, mag), maxSpeed), velX);
+        vfloat forceY = VSub(VMul(VDiv(edgeY, mag), maxSpeed), velY);
+        VLimit(&forceX, &forceY, zero, maxWallForce);
+
+        VStore(&swarm->velx[index], VSelect(nearWall, VAdd(velX, forceX), velX));
+        VStore(&swarm->vely[index], VSelect(nearWall, VAdd(velY, forceY), velY));
+    }
+}
+
+void IntegrateSwarm(Swarm* swarm)
+{
+    vfloat zero = VSet(0.0f);
+
+    for (unsigned int index = 0; index < swarm->count; index += SIMD_WIDTH)
+    {
+        vfloat velX = VLoad(&swarm->velx[index]);
+        vfloat velY = VLoad(&swarm->vely[index]);
+        vfloat mag = VSqrt(VAdd(VMul(velX, velX), VMul(velY, velY)));
+
+        VStore(&swarm->energy[index], VMax(zero, VSub(VLoad(&swarm->energy[index]), mag)));
+        VStore(&swarm->posx[index], VAdd(VLoad(&swarm->posx[index]), velX));
+        VStore(&swarm->posy[index], VAdd(VLoad(&swarm->posy[index]), velY));
+    }
+}
@@ -0,0 +1,43 @@
+/******************************************************
+ * File:           kernels.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Vectorized steering kernels over swarm arrays
+ ******************************************************/
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include "boid.h"
+
+// Neighbor sums per boid, filled by AccumulateNeighbors and consumed by ApplySteeringSums
+typedef struct {
+    float* sumx;
+    float* sumy;
+    float* total;
+} NeighborSums;
+
+typedef struct {
+    NeighborSums alignment;
+    NeighborSums cohesion;
+    NeighborSums separation;
+    unsigned int capacity;
+} FlockSums;
+
+const char* GetKernelName(void);
+void ReserveFlockSums(FlockSums* sums, unsigned int capacity);
+void FreeFlockSums(FlockSums* sums);
+
+// Sums alignment, cohesion and separation over slots [start, end) of bucket-ordered arrays, skipping skipSlot
+void AccumulateNeighbors(const float* posx, const float* posy, const float* velx, const float* vely,
+                         unsigned int start, unsigned int end, unsigned int skipSlot,
+                         float x, float y, FlockSums* sums, unsigned int boid);
+
+void ApplySteeringSums(Swarm* swarm, const NeighborSums* sums, float steerForce, bool normalizeFlag, bool subtractPosFlag);
+void ApplyEdges(Swarm* swarm, float width, float height);
+void IntegrateSwarm(Swarm* swarm);
+
+#endif // KERNELS_H
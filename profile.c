@@ -0,0 +1,178 @@
+/******************************************************
+ * File:           profile.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Scoped timers and work counters for the hot paths, compiled out unless BOID_PROFILE is defined
+ ******************************************************/
+
+#include "profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// A zone that finished, or for kind >= PROFILE_ZONE_COUNT a per-step counter sample
+typedef struct {
+    uint64_t start;
+    uint64_t value;            // Duration in nanoseconds, or the counter's change since the previous sample
+    uint16_t kind;
+    uint16_t thread;
+} TraceEvent;
+
+typedef struct {
+    TraceEvent* events;        // PROFILE_TRACE_EVENTS long once tracing started
+    unsigned int eventCount;   // Claimed slots, may run past PROFILE_TRACE_EVENTS
+    unsigned int threadCount;
+    uint64_t origin;           // ProfileNow when tracing started
+    uint64_t sampled[PROFILE_COUNTER_COUNT];
+} ProfileTrace;
+
+ProfileTotals profileTotals;
+static ProfileTrace trace;
+static _Thread_local unsigned int traceThread;
+
+static const char* zoneNames[PROFILE_ZONE_COUNT] = {
+    "step", "grid", "fire", "sections", "field", "flock", "target", "integrate", "spawn", "publish",
+    "render_grid", "render_targets", "render_boids", "present"
+};
+
+static const char* counterNames[PROFILE_COUNTER_COUNT] = {"neighbor_pairs", "cells_scanned", "cells_changed"};
+
+static void AppendTraceEvent(uint64_t start, uint64_t value, unsigned int kind)
+{
+    unsigned int slot = __atomic_fetch_add(&trace.eventCount, 1, __ATOMIC_RELAXED);
+    if (slot >= PROFILE_TRACE_EVENTS)
+    {
+        return;
+    }
+    if (traceThread == 0)
+    {
+        traceThread = __atomic_add_fetch(&trace.threadCount, 1, __ATOMIC_RELAXED);
+    }
+    trace.events[slot] = (TraceEvent){start, value, (uint16_t)kind, (uint16_t)traceThread};
+}
+
+void RecordProfileZone(ProfileZone zone, uint64_t start)
+{
+    RecordProfileSpan(zone, start, ProfileNow());
+}
+
+void RecordProfileSpan(ProfileZone zone, uint64_t start, uint64_t end)
+{
+    __atomic_fetch_add(&profileTotals.nanoseconds[zone], end - start, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&profileTotals.calls[zone], 1, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&trace.events, __ATOMIC_ACQUIRE))
+    {
+        AppendTraceEvent(start, end - start, zone);
+    }
+}
+
+// Called once a step by the stepping thread, so the samples line up with the step zones
+void SampleProfileCounters(void)
+{
+    if (!__atomic_load_n(&trace.events, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+    uint64_t now = ProfileNow();
+    for (unsigned int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++)
+    {
+        uint64_t total = __atomic_load_n(&profileTotals.counters[counter], __ATOMIC_RELAXED);
+        AppendTraceEvent(now, total - trace.sampled[counter], PROFILE_ZONE_COUNT + counter);
+        trace.sampled[counter] = total;
+    }
+}
+
+const char* GetProfileZoneName(ProfileZone zone)
+{
+    return zoneNames[zone];
+}
+
+const char* GetProfileCounterName(ProfileCounter counter)
+{
+    return counterNames[counter];
+}
+
+ProfileZone GetProfileZoneRoot(ProfileZone zone)
+{
+    return zone >= PROFILE_RENDER_GRID ? PROFILE_PRESENT : PROFILE_STEP;
+}
+
+void ReadProfileTotals(ProfileTotals* totals)
+{
+    for (unsigned int zone = 0; zone < PROFILE_ZONE_COUNT; zone++)
+    {
+        totals->nanoseconds[zone] = __atomic_load_n(&profileTotals.nanoseconds[zone], __ATOMIC_RELAXED);
+        totals->calls[zone] = __atomic_load_n(&profileTotals.calls[zone], __ATOMIC_RELAXED);
+    }
+    for (unsigned int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++)
+    {
+        totals->counters[counter] = __atomic_load_n(&profileTotals.counters[counter], __ATOMIC_RELAXED);
+    }
+}
+
+// Call before the threads that record start, the buffer is never moved afterwards
+void StartProfileTrace(void)
+{
+    if (trace.events)
+    {
+        return;
+    }
+    TraceEvent* events = (TraceEvent*)malloc(PROFILE_TRACE_EVENTS * sizeof(TraceEvent));
+    if (!events)
+    {
+        fprintf(stderr, "Memory allocation failed for profile trace\n");
+        exit(1);
+    }
+    trace.origin = ProfileNow();
+    for (unsigned int counter = 0; counter < PROFILE_COUNTER_COUNT; counter++)
+    {
+        trace.sampled[counter] = __atomic_load_n(&profileTotals.counters[counter], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&trace.events, events, __ATOMIC_RELEASE);
+}
+
+// Call after the threads that record have stopped. Timestamps are microseconds since StartProfileTrace.
+bool WriteProfileTrace(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file)
+    {
+        fprintf(stderr, "Could not open trace file %s\n", path);
+        return false;
+    }
+
+    unsigned int eventCount = trace.eventCount < PROFILE_TRACE_EVENTS ? trace.eventCount : PROFILE_TRACE_EVENTS;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"boid-firefight\"}}");
+    for (unsigned int index = 0; index < eventCount; index++)
+    {
+        const TraceEvent* event = &trace.events[index];
+        double start = (double)(int64_t)(event->start - trace.origin) / 1000.0;
+        if (event->kind < PROFILE_ZONE_COUNT)
+        {
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                    zoneNames[event->kind], event->thread, start, event->value / 1000.0);
+        }
+        else
+        {
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"per_step\":%llu}}",
+                    counterNames[event->kind - PROFILE_ZONE_COUNT], event->thread, start,
+                    (unsigned long long)event->value);
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    bool written = !ferror(file);
+    if (fclose(file) != 0 || !written)
+    {
+        fprintf(stderr, "Could not write trace file %s\n", path);
+        return false;
+    }
+    if (trace.eventCount > PROFILE_TRACE_EVENTS)
+    {
+        fprintf(stderr, "Trace buffer filled up, %u later events were dropped\n", trace.eventCount - PROFILE_TRACE_EVENTS);
+    }
+    return true;
+}
@@ -0,0 +1,92 @@
+/******************************************************
+ * File:           profile.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Scoped timers and work counters for the hot paths, compiled out unless BOID_PROFILE is defined
+ ******************************************************/
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#define PROFILE_TRACE_EVENTS (1u << 20) // Trace events kept after StartProfileTrace, later ones are dropped
+
+// Zones nest: the simulation ones inside PROFILE_STEP, the render ones between two PROFILE_PRESENT.
+// GRID through SPAWN are the SimulationPhase spans, charged by StepOnce's phase marks.
+typedef enum {
+    PROFILE_STEP,            // One StepSimulation step
+    PROFILE_GRID,            // Fire step, section intensities and the section pyramid
+    PROFILE_FIRE,            // Fire engine step, inside PROFILE_GRID
+    PROFILE_SECTIONS,        // Section intensity scoring, inside PROFILE_GRID
+    PROFILE_FIELD,           // Nearest-burning-cell field
+    PROFILE_FLOCK,           // Wall forces, spatial hash and neighbor sums
+    PROFILE_TARGET,          // Target search, claims and extinguishing
+    PROFILE_INTEGRATE,
+    PROFILE_SPAWN,           // Spread schedule, spawn and remove, charged twice a step
+    PROFILE_PUBLISH,         // Copy into shared memory after a step
+    PROFILE_RENDER_GRID,
+    PROFILE_RENDER_TARGETS,
+    PROFILE_RENDER_BOIDS,
+    PROFILE_PRESENT,
+    PROFILE_ZONE_COUNT
+} ProfileZone;
+
+typedef enum {
+    PROFILE_NEIGHBOR_PAIRS,  // Boid pairs compared while flocking
+    PROFILE_CELLS_SCANNED,   // Cells the fire engine looked at
+    PROFILE_CELLS_CHANGED,   // Cell state changes
+    PROFILE_COUNTER_COUNT
+} ProfileCounter;
+
+// Running totals since start, updated with relaxed atomics from any thread
+typedef struct {
+    uint64_t nanoseconds[PROFILE_ZONE_COUNT];
+    uint64_t calls[PROFILE_ZONE_COUNT];
+    uint64_t counters[PROFILE_COUNTER_COUNT];
+} ProfileTotals;
+
+extern ProfileTotals profileTotals;
+
+static inline uint64_t ProfileNow(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+void RecordProfileZone(ProfileZone zone, uint64_t start);
+void RecordProfileSpan(ProfileZone zone, uint64_t start, uint64_t end);  // For zones timed by the caller
+void SampleProfileCounters(void);
+
+#ifdef BOID_PROFILE
+#define PROFILE_ENABLED 1
+// Brackets a scope: both in the same block, with nothing returning in between
+#define PROFILE_BEGIN(zone) uint64_t profileStart_##zone = ProfileNow()
+#define PROFILE_END(zone) RecordProfileZone(zone, profileStart_##zone)
+#define PROFILE_COUNT(counter, amount) __atomic_fetch_add(&profileTotals.counters[counter], (amount), __ATOMIC_RELAXED)
+#define PROFILE_SAMPLE_COUNTERS() SampleProfileCounters()
+#else
+#define PROFILE_ENABLED 0
+#define PROFILE_BEGIN(zone) ((void)0)
+#define PROFILE_END(zone) ((void)0)
+#define PROFILE_COUNT(counter, amount) ((void)(amount))
+#define PROFILE_SAMPLE_COUNTERS() ((void)0)
+#endif
+
+const char* GetProfileZoneName(ProfileZone zone);
+const char* GetProfileCounterName(ProfileCounter counter);
+ProfileZone GetProfileZoneRoot(ProfileZone zone);  // Zone whose calls a zone's time is averaged over
+void ReadProfileTotals(ProfileTotals* totals);
+
+// Chrome trace event format, opens in chrome://tracing and ui.perfetto.dev. Writing reports failures
+// on stderr and returns false.
+void StartProfileTrace(void);
+bool WriteProfileTrace(const char* path);
+
+#endif // PROFILE_H
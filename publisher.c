@@ -0,0 +1,285 @@
+/******************************************************
+ * File:           publisher.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Per-step simulation state in POSIX shared memory for any number of local readers
+ ******************************************************/
+
+#include "publisher.h"
+#include "profile.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static uint64_t AlignUp(uint64_t offset)
+{
+    return (offset + PUBLISH_ALIGNMENT - 1) / PUBLISH_ALIGNMENT * PUBLISH_ALIGNMENT;
+}
+
+static PublishSlot* GetSlot(const PublishHeader* header, unsigned char* base, uint64_t publish)
+{
+    return (PublishSlot*)(base + header->slotsOffset + ((publish - 1) % header->slotCount) * header->slotSize);
+}
+
+bool OpenPublisher(Publisher* publisher, Simulation* sim, const char* name)
+{
+    memset(publisher, 0, sizeof(*publisher));
+    if (strlen(name) >= sizeof(publisher->name))
+    {
+        fprintf(stderr, "Shared memory name %s is too long\n", name);
+        return false;
+    }
+    strcpy(publisher->name, name);
+
+    // Slots hold the capacity reserved for maxBoids, a swarm grown past it later is cut to fit
+    const Grid* grid = &sim->grid;
+    uint32_t boidCapacity = sim->swarm.capacity;
+    bool cells = (uint64_t)grid->rows * grid->cols <= PUBLISH_MAX_CELLS;
+    uint64_t blockSizes[PUBLISH_BLOCK_COUNT] = {
+        (uint64_t)boidCapacity * sizeof(float), (uint64_t)boidCapacity * sizeof(float),
+        (uint64_t)boidCapacity * sizeof(float), (uint64_t)boidCapacity * sizeof(float),
+        (uint64_t)boidCapacity * sizeof(float), boidCapacity,
+        (uint64_t)sim->numSectionsX * sim->numSectionsY * sizeof(float),
+        cells ? (uint64_t)grid->rows * grid->cols : 0
+    };
+
+    PublishHeader layout;
+    memset(&layout, 0, sizeof(layout));
+    uint64_t offset = AlignUp(sizeof(PublishSlot));
+    for (unsigned int block = 0; block < PUBLISH_BLOCK_COUNT; block++)
+    {
+        if (blockSizes[block] > 0)
+        {
+            layout.blockOffsets[block] = offset;
+            offset = AlignUp(offset + blockSizes[block]);
+        }
+    }
+    layout.slotCount = PUBLISH_SLOTS;
+    layout.slotSize = offset;
+    layout.slotsOffset = AlignUp(sizeof(PublishHeader));
+    publisher->size = layout.slotsOffset + PUBLISH_SLOTS * layout.slotSize;
+
+    int file = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (file < 0)
+    {
+        fprintf(stderr, "Could not create shared memory %s\n", name);
+        return false;
+    }
+    if (ftruncate(file, (off_t)publisher->size) != 0)
+    {
+        fprintf(stderr, "Could not size shared memory %s to %zu bytes\n", name, publisher->size);
+        close(file);
+        shm_unlink(name);
+        return false;
+    }
+    void* base = mmap(NULL, publisher->size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    close(file);
+    if (base == MAP_FAILED)
+    {
+        fprintf(stderr, "Could not map shared memory %s\n", name);
+        shm_unlink(name);
+        return false;
+    }
+    publisher->base = (unsigned char*)base;
+    publisher->header = (PublishHeader*)base;
+
+    if (cells)
+    {
+        // Every row counts as changed before the first publish, so each slot starts with the whole grid
+        publisher->rowSteps = (uint64_t*)malloc(grid->rows * sizeof(uint64_t));
+        if (!publisher->rowSteps)
+        {
+            fprintf(stderr, "Memory allocation failed for publisher rows\n");
+            exit(1);
+        }
+        for (unsigned int row = 0; row < grid->rows; row++)
+        {
+            publisher->rowSteps[row] = 1;
+        }
+    }
+
+    // The segment comes zeroed, published stays 0 until the first step is in
+    PublishHeader* header = publisher->header;
+    header->version = PUBLISH_VERSION;
+    header->slotCount = layout.slotCount;
+    header->slotsOffset = layout.slotsOffset;
+    header->slotSize = layout.slotSize;
+    memcpy(header->blockOffsets, layout.blockOffsets, sizeof(layout.blockOffsets));
+    header->seed = sim->seed;
+    header->engine = grid->engine;
+    header->cols = grid->cols;
+    header->rows = grid->rows;
+    header->cellSize = CELL_SIZE;
+    header->boidCapacity = boidCapacity;
+    header->numSectionsX = sim->numSectionsX;
+    header->numSectionsY = sim->numSectionsY;
+    header->writerPid = (uint32_t)getpid();
+    for (unsigned int target = 0; target < NUM_HOME_TARGETS; target++)
+    {
+        header->homeTargets[target][0] = sim->homeTargets[target].x;
+        header->homeTargets[target][1] = sim->homeTargets[target].y;
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(header->magic, PUBLISH_MAGIC, sizeof(header->magic));
+    return true;
+}
+
+// Copies one step into the oldest slot. Boid arrays and sections are copied whole, cells only for the
+// rows that changed since that slot was last written.
+void PublishFrame(Publisher* publisher, Simulation* sim)
+{
+    PROFILE_BEGIN(PROFILE_PUBLISH);
+    PublishHeader* header = publisher->header;
+    Grid* grid = &sim->grid;
+    const Swarm* swarm = &sim->swarm;
+    uint64_t publish = header->published + 1;
+
+    if (publisher->rowSteps)
+    {
+        for (unsigned int row = 0; row < grid->rows; row++)
+        {
+            if (grid->dirtyRows[row] & DIRTY_ROW_PUBLISH)
+            {
+                grid->dirtyRows[row] &= ~DIRTY_ROW_PUBLISH;
+                publisher->rowSteps[row] = publish;
+            }
+        }
+    }
+
+    unsigned int slotIndex = (unsigned int)((publish - 1) % PUBLISH_SLOTS);
+    PublishSlot* slot = GetSlot(header, publisher->base, publish);
+    unsigned char* data = (unsigned char*)slot;
+    uint64_t sequence = slot->sequence;
+    __atomic_store_n(&slot->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    unsigned int count = swarm->count < header->boidCapacity ? swarm->count : header->boidCapacity;
+    memcpy(data + header->blockOffsets[PUBLISH_POSX], swarm->posx, count * sizeof(float));
+    memcpy(data + header->blockOffsets[PUBLISH_POSY], swarm->posy, count * sizeof(float));
+    memcpy(data + header->blockOffsets[PUBLISH_VELX], swarm->velx, count * sizeof(float));
+    memcpy(data + header->blockOffsets[PUBLISH_VELY], swarm->vely, count * sizeof(float));
+    memcpy(data + header->blockOffsets[PUBLISH_ENERGY], swarm->energy, count * sizeof(float));
+    memcpy(data + header->blockOffsets[PUBLISH_FLAGS], swarm->flags, count);
+
+    float* sections = (float*)(data + header->blockOffsets[PUBLISH_SECTIONS]);
+    for (unsigned int sectionX = 0; sectionX < sim->numSectionsX; sectionX++)
+    {
+        memcpy(sections + sectionX * sim->numSectionsY, sim->sectionIntensity[sectionX],
+               sim->numSectionsY * sizeof(float));
+    }
+
+    if (publisher->rowSteps)
+    {
+        unsigned char* cells = data + header->blockOffsets[PUBLISH_CELLS];
+        for (unsigned int row = 0; row < grid->rows; row++)
+        {
+            if (publisher->rowSteps[row] > publisher->slotSteps[slotIndex])
+            {
+                unsigned char* rowCells = cells + (size_t)row * grid->cols;
+                for (unsigned int col = 0; col < grid->cols; col++)
+                {
+                    rowCells[col] = GetCellState(grid, row, col);
+                }
+            }
+        }
+    }
+    publisher->slotSteps[slotIndex] = publish;
+
+    slot->frame = sim->frame;
+    slot->boidCount = count;
+    slot->totalBurning = sim->totalBurning;
+    memcpy(slot->cellCounts, grid->cellCounts, sizeof(slot->cellCounts));
+
+    __atomic_store_n(&slot->sequence, sequence + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&header->published, publish, __ATOMIC_RELEASE);
+    PROFILE_END(PROFILE_PUBLISH);
+}
+
+void ClosePublisher(Publisher* publisher)
+{
+    __atomic_store_n(&publisher->header->closed, 1, __ATOMIC_RELEASE);
+    munmap(publisher->base, publisher->size);
+    shm_unlink(publisher->name);
+    free(publisher->rowSteps);
+    publisher->rowSteps = NULL;
+    publisher->base = NULL;
+    publisher->header = NULL;
+}
+
+bool OpenPublishReader(PublishReader* reader, const char* name)
+{
+    memset(reader, 0, sizeof(*reader));
+    int file = shm_open(name, O_RDONLY, 0);
+    if (file < 0)
+    {
+        fprintf(stderr, "Could not open shared memory %s\n", name);
+        return false;
+    }
+    struct stat info;
+    void* base = MAP_FAILED;
+    if (fstat(file, &info) == 0 && (size_t)info.st_size >= sizeof(PublishHeader))
+    {
+        base = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    }
+    close(file);
+    if (base == MAP_FAILED)
+    {
+        fprintf(stderr, "Could not map shared memory %s\n", name);
+        return false;
+    }
+
+    const PublishHeader* header = (const PublishHeader*)base;
+    bool valid = memcmp(header->magic, PUBLISH_MAGIC, sizeof(header->magic)) == 0;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    valid = valid && header->version == PUBLISH_VERSION && header->slotCount > 0 &&
+            header->slotsOffset + (uint64_t)header->slotCount * header->slotSize <= (uint64_t)info.st_size;
+    if (!valid)
+    {
+        fprintf(stderr, "Shared memory %s is not a boid-firefight publisher of version %u\n", name, PUBLISH_VERSION);
+        munmap(base, (size_t)info.st_size);
+        return false;
+    }
+    reader->base = (const unsigned char*)base;
+    reader->size = (size_t)info.st_size;
+    reader->header = header;
+    return true;
+}
+
+const PublishSlot* BeginPublishRead(const PublishReader* reader, uint64_t* sequence)
+{
+    // An odd sequence on the newest slot means the writer has lapped the ring since published was read
+    for (;;)
+    {
+        uint64_t published = __atomic_load_n(&reader->header->published, __ATOMIC_ACQUIRE);
+        if (published == 0)
+        {
+            return NULL;
+        }
+        const PublishSlot* slot = GetSlot(reader->header, (unsigned char*)reader->base, published);
+        *sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if (!(*sequence & 1))
+        {
+            return slot;
+        }
+    }
+}
+
+bool EndPublishRead(const PublishSlot* slot, uint64_t sequence)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == sequence;
+}
+
+void ClosePublishReader(PublishReader* reader)
+{
+    munmap((void*)reader->base, reader->size);
+    reader->base = NULL;
+    reader->header = NULL;
+}
@@ -0,0 +1,108 @@
+/******************************************************
+ * File:           publisher.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Per-step simulation state in POSIX shared memory for any number of local readers
+ ******************************************************/
+
+#ifndef PUBLISHER_H
+#define PUBLISHER_H
+
+#include "simulation.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PUBLISH_MAGIC "BOIDSHM1"
+#define PUBLISH_VERSION 1
+#define PUBLISH_SLOTS 4                 // Steps a reader has to finish with a slot before it is overwritten
+#define PUBLISH_ALIGNMENT 64            // Every block starts on a cache line
+#define PUBLISH_MAX_CELLS (64u << 20)   // Larger worlds publish no cell states, only the boids and sections
+
+// Arrays in each slot after its PublishSlot header
+typedef enum {
+    PUBLISH_POSX,                  // float[boidCapacity], pixels
+    PUBLISH_POSY,
+    PUBLISH_VELX,
+    PUBLISH_VELY,
+    PUBLISH_ENERGY,
+    PUBLISH_FLAGS,                 // uint8[boidCapacity], BOID_HEADING_HOME | BOID_TO_BE_REMOVED
+    PUBLISH_SECTIONS,              // float[numSectionsX][numSectionsY], section intensities
+    PUBLISH_CELLS,                 // uint8[rows][cols], cell states, absent (offset 0) past PUBLISH_MAX_CELLS
+    PUBLISH_BLOCK_COUNT
+} PublishBlock;
+
+/*
+ * Segment layout, in the writer's byte order:
+ *   PublishHeader
+ *   PUBLISH_SLOTS slots of slotSize bytes from slotsOffset, each a PublishSlot then its blocks
+ * The writer fills slot n % PUBLISH_SLOTS for its nth publish, then sets published to n + 1. Each slot
+ * is a seqlock: its sequence is odd while the writer is in it and grows by 2 per write, so a reader
+ * that sees the same even sequence before and after reading a slot has a consistent step.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t slotCount;
+    uint64_t slotsOffset;
+    uint64_t slotSize;
+    uint64_t blockOffsets[PUBLISH_BLOCK_COUNT]; // From the start of a slot
+    uint64_t seed;
+    uint32_t engine;
+    uint32_t cols;
+    uint32_t rows;
+    uint32_t cellSize;                  // Pixels per cell
+    uint32_t boidCapacity;              // Boids a slot holds, a larger swarm is cut to this many
+    uint32_t numSectionsX;
+    uint32_t numSectionsY;
+    uint32_t writerPid;
+    int32_t homeTargets[NUM_HOME_TARGETS][2]; // Pixel x and y, fixed for the whole run
+    _Alignas(PUBLISH_ALIGNMENT) uint64_t published; // Publishes so far, the newest step is in slot (published - 1) % slotCount
+    uint32_t closed;                    // Set when the writer stops, the last step stays readable
+} PublishHeader;
+
+typedef struct {
+    uint64_t sequence;
+    uint64_t frame;                // Simulation frame after the step
+    uint32_t boidCount;
+    float totalBurning;
+    uint64_t cellCounts[CELL_STATE_COUNT]; // Cells in each state
+} PublishSlot;
+
+typedef struct {
+    char name[256];
+    unsigned char* base;           // The mapped segment
+    size_t size;
+    PublishHeader* header;
+    uint64_t* rowSteps;            // Per row, publish of the last change, NULL when cells are not published
+    uint64_t slotSteps[PUBLISH_SLOTS]; // Publish each slot last held
+} Publisher;
+
+typedef struct {
+    const unsigned char* base;
+    size_t size;
+    const PublishHeader* header;
+} PublishReader;
+
+// Writer side, called from the thread that steps sim. The name is a POSIX shared-memory name, "/boid".
+bool OpenPublisher(Publisher* publisher, Simulation* sim, const char* name);
+void PublishFrame(Publisher* publisher, Simulation* sim);
+void ClosePublisher(Publisher* publisher);  // Removes the name, mapped readers keep the segment
+
+// Reader side, no syscalls after OpenPublishReader. BeginPublishRead returns the newest slot, or NULL
+// before the first publish; its contents are a consistent step only if EndPublishRead then returns true.
+bool OpenPublishReader(PublishReader* reader, const char* name);
+const PublishSlot* BeginPublishRead(const PublishReader* reader, uint64_t* sequence);
+bool EndPublishRead(const PublishSlot* slot, uint64_t sequence);
+void ClosePublishReader(PublishReader* reader);
+
+static inline const void* GetPublishBlock(const PublishReader* reader, const PublishSlot* slot, PublishBlock block)
+{
+    uint64_t offset = reader->header->blockOffsets[block];
+    return offset ? (const unsigned char*)slot + offset : NULL;
+}
+
+#endif
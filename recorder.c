@@ -0,0 +1,445 @@
+/******************************************************
+ * File:           recorder.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Compressed per-frame recording of boids and cell transitions, written off the sim thread
+ ******************************************************/
+
+#include "recorder.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+// Grows a byte buffer to hold at least needed bytes, keeping its contents
+static void ReserveBytes(unsigned char** buffer, size_t* capacity, size_t needed, const char* what)
+{
+    if (needed <= *capacity)
+    {
+        return;
+    }
+    size_t newCapacity = *capacity ? *capacity : 4096;
+    while (newCapacity < needed)
+    {
+        newCapacity *= 2;
+    }
+    unsigned char* grown = (unsigned char*)realloc(*buffer, newCapacity);
+    if (!grown)
+    {
+        fprintf(stderr, "Memory allocation failed for %s\n", what);
+        exit(1);
+    }
+    *buffer = grown;
+    *capacity = newCapacity;
+}
+
+// Copies the states of one row of cells into the slot
+static void AddSpan(RecordSlot* slot, size_t* used, const Grid* grid, unsigned int row, unsigned int col,
+                    unsigned int width)
+{
+    if (slot->spanCount == slot->spanCapacity)
+    {
+        unsigned int newCapacity = slot->spanCapacity ? slot->spanCapacity * 2 : 256;
+        RecordSpan* spans = (RecordSpan*)realloc(slot->spans, newCapacity * sizeof(RecordSpan));
+        if (!spans)
+        {
+            fprintf(stderr, "Memory allocation failed for recorder spans\n");
+            exit(1);
+        }
+        slot->spans = spans;
+        slot->spanCapacity = newCapacity;
+    }
+    slot->spans[slot->spanCount++] = (RecordSpan){row, col, width};
+
+    ReserveBytes(&slot->data, &slot->capacity, *used + width, "recorder frame");
+    unsigned char* states = slot->data + *used;
+    for (unsigned int index = 0; index < width; index++)
+    {
+        states[index] = GetCellState(grid, row, col + index);
+    }
+    *used += width;
+}
+
+// Spans for the rows of one chunk that lie inside the world, only the dirty ones unless all is set
+static void AddChunkSpans(RecordSlot* slot, size_t* used, const Grid* grid, unsigned int chunkIndex, bool all)
+{
+    unsigned int firstRow = (chunkIndex / grid->chunkCols) * CHUNK_SIZE;
+    unsigned int firstCol = (chunkIndex % grid->chunkCols) * CHUNK_SIZE;
+    unsigned int lastRow = firstRow + CHUNK_SIZE < grid->rows ? firstRow + CHUNK_SIZE : grid->rows;
+    unsigned int width = firstCol + CHUNK_SIZE < grid->cols ? CHUNK_SIZE : grid->cols - firstCol;
+
+    for (unsigned int row = firstRow; row < lastRow; row++)
+    {
+        if (all || (grid->dirtyRows[row] & DIRTY_ROW_RECORD))
+        {
+            AddSpan(slot, used, grid, row, firstCol, width);
+        }
+    }
+}
+
+void RecordFrame(Recorder* recorder, Simulation* sim)
+{
+    if (__atomic_load_n(&recorder->failed, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    // Full ring: drop the frame and leave the dirty rows set, the next recorded frame carries the changes.
+    // Chunks may be packed once nothing changed in them for CHUNK_IDLE_TICKS, after which their rows
+    // are no longer found through the live list, so a long run of drops ends with a full frame.
+    unsigned int head = recorder->head;
+    if (head - __atomic_load_n(&recorder->tail, __ATOMIC_ACQUIRE) == RECORD_RING_SLOTS)
+    {
+        recorder->droppedFrames++;
+        if (++recorder->consecutiveDrops >= CHUNK_IDLE_TICKS)
+        {
+            recorder->needsFull = true;
+        }
+        return;
+    }
+    recorder->consecutiveDrops = 0;
+
+    RecordSlot* slot = &recorder->slots[head % RECORD_RING_SLOTS];
+    const Swarm* swarm = &sim->swarm;
+    Grid* grid = &sim->grid;
+    unsigned int count = swarm->count;
+
+    size_t used = (size_t)count * (4 * sizeof(float) + 1);
+    ReserveBytes(&slot->data, &slot->capacity, used, "recorder frame");
+    float* floats = (float*)slot->data;
+    memcpy(floats, swarm->posx, count * sizeof(float));
+    memcpy(floats + count, swarm->posy, count * sizeof(float));
+    memcpy(floats + 2 * count, swarm->velx, count * sizeof(float));
+    memcpy(floats + 3 * count, swarm->vely, count * sizeof(float));
+    memcpy(slot->data + 4 * count * sizeof(float), swarm->flags, count);
+
+    slot->spanCount = 0;
+    slot->full = recorder->needsFull;
+    if (slot->full)
+    {
+        for (unsigned int chunkIndex = 0; chunkIndex < grid->chunkRows * grid->chunkCols; chunkIndex++)
+        {
+            const ChunkSlot* chunk = &grid->chunks[chunkIndex];
+            if (chunk->live || chunk->packed || chunk->uniform != 0)
+            {
+                AddChunkSpans(slot, &used, grid, chunkIndex, true);
+            }
+        }
+    }
+    else
+    {
+        // Cells only change in live chunks
+        for (unsigned int position = 0; position < grid->liveCount; position++)
+        {
+            AddChunkSpans(slot, &used, grid, grid->liveChunks[position], false);
+        }
+    }
+    for (unsigned int row = 0; row < grid->rows; row++)
+    {
+        grid->dirtyRows[row] &= ~DIRTY_ROW_RECORD;
+    }
+
+    slot->frame = sim->frame;
+    slot->boidCount = count;
+    recorder->needsFull = false;
+    __atomic_store_n(&recorder->head, head + 1, __ATOMIC_RELEASE);
+}
+
+static void AppendTransition(Recorder* recorder, size_t* rawSize, uint64_t* previous, uint64_t cell,
+                             unsigned char state)
+{
+    ReserveBytes(&recorder->raw, &recorder->rawCapacity, *rawSize + 11, "recorder frame");
+    int64_t delta = (int64_t)(cell - *previous);
+    uint64_t zigzag = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+    unsigned char* out = recorder->raw + *rawSize;
+    while (zigzag >= 0x80)
+    {
+        *out++ = (unsigned char)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    *out++ = (unsigned char)zigzag;
+    *out++ = state;
+    *rawSize = out - recorder->raw;
+    *previous = cell;
+}
+
+static void QuantizeBoids(Recorder* recorder, const RecordSlot* slot)
+{
+    unsigned int count = slot->boidCount;
+    const float* posx = (const float*)slot->data;
+    const float* posy = posx + count;
+    const float* velx = posx + 2 * count;
+    const float* vely = posx + 3 * count;
+    uint16_t* outx = (uint16_t*)recorder->raw;
+    uint16_t* outy = outx + count;
+    int8_t* outvx = (int8_t*)(outy + count);
+    int8_t* outvy = outvx + count;
+
+    for (unsigned int boid = 0; boid < count; boid++)
+    {
+        outx[boid] = (uint16_t)fminf(fmaxf(lrintf(posx[boid] / recorder->header.positionStepX), 0), 65535);
+        outy[boid] = (uint16_t)fminf(fmaxf(lrintf(posy[boid] / recorder->header.positionStepY), 0), 65535);
+        outvx[boid] = (int8_t)fminf(fmaxf(lrintf(velx[boid] / recorder->header.velocityStep), -127), 127);
+        outvy[boid] = (int8_t)fminf(fmaxf(lrintf(vely[boid] / recorder->header.velocityStep), -127), 127);
+    }
+    memcpy(outvy + count, slot->data + 4 * count * sizeof(float), count);
+}
+
+static bool WriteBytes(Recorder* recorder, const void* bytes, size_t size)
+{
+    if (fwrite(bytes, 1, size, recorder->file) != size)
+    {
+        fprintf(stderr, "Failed to write recording\n");
+        return false;
+    }
+    recorder->offset += size;
+    return true;
+}
+
+// Writer thread: diffs the slot's spans against the last recorded states and writes one frame
+static bool WriteSlot(Recorder* recorder, const RecordSlot* slot)
+{
+    unsigned int count = slot->boidCount;
+    size_t rawSize = (size_t)count * 7;
+    ReserveBytes(&recorder->raw, &recorder->rawCapacity, rawSize, "recorder frame");
+    QuantizeBoids(recorder, slot);
+
+    if (slot->full)
+    {
+        for (unsigned int chunkIndex = 0; chunkIndex < recorder->chunkRows * recorder->chunkCols; chunkIndex++)
+        {
+            free(recorder->mirror[chunkIndex]);
+            recorder->mirror[chunkIndex] = NULL;
+        }
+    }
+    bool keyframe = slot->full || recorder->indexCount == 0 ||
+                    recorder->sinceKeyframe >= RECORD_KEYFRAME_INTERVAL;
+
+    uint32_t transitions = 0;
+    uint64_t previous = 0;
+    const unsigned char* states = slot->data + (size_t)count * (4 * sizeof(float) + 1);
+    for (unsigned int span = 0; span < slot->spanCount; span++)
+    {
+        RecordSpan s = slot->spans[span];
+        unsigned int chunkIndex = (s.row >> CHUNK_SHIFT) * recorder->chunkCols + (s.col >> CHUNK_SHIFT);
+        unsigned char* mirror = recorder->mirror[chunkIndex];
+        unsigned char* row = mirror ? mirror + GetChunkOffset(s.row, s.col) : NULL;
+        for (unsigned int index = 0; index < s.width; index++)
+        {
+            unsigned char state = states[index];
+            if (state == (row ? row[index] : 0))
+            {
+                continue;
+            }
+            if (!row)
+            {
+                mirror = recorder->mirror[chunkIndex] = (unsigned char*)calloc(CHUNK_CELLS, 1);
+                if (!mirror)
+                {
+                    fprintf(stderr, "Memory allocation failed for recorder mirror\n");
+                    exit(1);
+                }
+                row = mirror + GetChunkOffset(s.row, s.col);
+            }
+            row[index] = state;
+            if (!keyframe)
+            {
+                AppendTransition(recorder, &rawSize, &previous, (uint64_t)s.row * recorder->cols + s.col + index, state);
+                transitions++;
+            }
+        }
+        states += s.width;
+    }
+
+    if (keyframe)
+    {
+        for (unsigned int chunkIndex = 0; chunkIndex < recorder->chunkRows * recorder->chunkCols; chunkIndex++)
+        {
+            const unsigned char* mirror = recorder->mirror[chunkIndex];
+            if (!mirror)
+            {
+                continue;
+            }
+            uint64_t firstRow = (chunkIndex / recorder->chunkCols) * CHUNK_SIZE;
+            uint64_t firstCol = (chunkIndex % recorder->chunkCols) * CHUNK_SIZE;
+            for (unsigned int offset = 0; offset < CHUNK_CELLS; offset++)
+            {
+                if (mirror[offset])
+                {
+                    uint64_t cell = (firstRow + offset / CHUNK_SIZE) * recorder->cols + firstCol + offset % CHUNK_SIZE;
+                    AppendTransition(recorder, &rawSize, &previous, cell, mirror[offset]);
+                    transitions++;
+                }
+            }
+        }
+        recorder->sinceKeyframe = 0;
+        recorder->lastKeyframeEntry = (uint32_t)recorder->indexCount;
+    }
+    recorder->sinceKeyframe++;
+
+    uLongf compressedSize = compressBound(rawSize);
+    ReserveBytes(&recorder->compressed, &recorder->compressedCapacity, compressedSize, "recorder compression");
+    if (compress2(recorder->compressed, &compressedSize, recorder->raw, rawSize, Z_BEST_SPEED) != Z_OK)
+    {
+        fprintf(stderr, "Compression failed for recording\n");
+        return false;
+    }
+
+    if (recorder->indexCount == recorder->indexCapacity)
+    {
+        unsigned long long newCapacity = recorder->indexCapacity ? recorder->indexCapacity * 2 : 1024;
+        RecordIndexEntry* index = (RecordIndexEntry*)realloc(recorder->index, newCapacity * sizeof(RecordIndexEntry));
+        if (!index)
+        {
+            fprintf(stderr, "Memory allocation failed for recorder index\n");
+            exit(1);
+        }
+        recorder->index = index;
+        recorder->indexCapacity = newCapacity;
+    }
+    recorder->index[recorder->indexCount++] = (RecordIndexEntry){slot->frame, recorder->offset,
+                                                                  recorder->lastKeyframeEntry, 0};
+
+    RecordFrameHeader frameHeader = {slot->frame, (uint32_t)compressedSize, (uint32_t)rawSize, count,
+                                     transitions, keyframe, 0};
+    return WriteBytes(recorder, &frameHeader, sizeof(frameHeader)) &&
+           WriteBytes(recorder, recorder->compressed, compressedSize);
+}
+
+// Polls rather than waiting on a condition variable, so RecordFrame never takes a lock
+static void* WriterMain(void* argument)
+{
+    Recorder* recorder = (Recorder*)argument;
+    const struct timespec idle = {0, RECORD_IDLE_SLEEP_NS};
+
+    for (;;)
+    {
+        // Closing is read before head, so a set flag with an empty ring means every frame is written
+        bool closing = __atomic_load_n(&recorder->closing, __ATOMIC_ACQUIRE);
+        unsigned int tail = recorder->tail;
+        if (tail == __atomic_load_n(&recorder->head, __ATOMIC_ACQUIRE))
+        {
+            if (closing)
+            {
+                break;
+            }
+            nanosleep(&idle, NULL);
+            continue;
+        }
+
+        if (!recorder->failed && !WriteSlot(recorder, &recorder->slots[tail % RECORD_RING_SLOTS]))
+        {
+            __atomic_store_n(&recorder->failed, true, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&recorder->tail, tail + 1, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+static void FreeRecorderBuffers(Recorder* recorder)
+{
+    for (unsigned int slot = 0; slot < RECORD_RING_SLOTS; slot++)
+    {
+        free(recorder->slots[slot].data);
+        free(recorder->slots[slot].spans);
+    }
+    if (recorder->mirror)
+    {
+        for (unsigned int chunkIndex = 0; chunkIndex < recorder->chunkRows * recorder->chunkCols; chunkIndex++)
+        {
+            free(recorder->mirror[chunkIndex]);
+        }
+    }
+    free(recorder->mirror);
+    free(recorder->raw);
+    free(recorder->compressed);
+    free(recorder->index);
+    recorder->mirror = NULL;
+    recorder->raw = NULL;
+    recorder->compressed = NULL;
+    recorder->index = NULL;
+}
+
+bool OpenRecorder(Recorder* recorder, const Simulation* sim, const char* path)
+{
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->cols = sim->grid.cols;
+    recorder->rows = sim->grid.rows;
+    recorder->chunkCols = sim->grid.chunkCols;
+    recorder->chunkRows = sim->grid.chunkRows;
+    recorder->needsFull = true;
+
+    RecordHeader* header = &recorder->header;
+    memcpy(header->magic, RECORD_MAGIC, sizeof(header->magic));
+    header->version = RECORD_VERSION;
+    header->keyframeInterval = RECORD_KEYFRAME_INTERVAL;
+    header->engine = sim->grid.engine;
+    header->cols = sim->grid.cols;
+    header->rows = sim->grid.rows;
+    header->seed = sim->seed;
+    header->positionStepX = sim->worldWidth / RECORD_POSITION_LEVELS;
+    header->positionStepY = sim->worldHeight / RECORD_POSITION_LEVELS;
+    header->velocityStep = MAX_SPEED / RECORD_VELOCITY_LEVELS;
+    for (unsigned int target = 0; target < NUM_HOME_TARGETS; target++)
+    {
+        header->homeTargets[target][0] = sim->homeTargets[target].x;
+        header->homeTargets[target][1] = sim->homeTargets[target].y;
+    }
+
+    recorder->mirror = (unsigned char**)calloc((size_t)recorder->chunkRows * recorder->chunkCols, sizeof(unsigned char*));
+    if (!recorder->mirror)
+    {
+        fprintf(stderr, "Memory allocation failed for recorder mirror\n");
+        exit(1);
+    }
+
+    recorder->file = fopen(path, "wb");
+    if (!recorder->file)
+    {
+        fprintf(stderr, "Cannot open recording %s for writing\n", path);
+        FreeRecorderBuffers(recorder);
+        return false;
+    }
+    if (!WriteBytes(recorder, header, sizeof(*header)))
+    {
+        fclose(recorder->file);
+        FreeRecorderBuffers(recorder);
+        return false;
+    }
+
+    if (pthread_create(&recorder->writer, NULL, WriterMain, recorder) != 0)
+    {
+        fprintf(stderr, "Thread creation failed for recorder\n");
+        fclose(recorder->file);
+        FreeRecorderBuffers(recorder);
+        return false;
+    }
+    return true;
+}
+
+bool CloseRecorder(Recorder* recorder)
+{
+    __atomic_store_n(&recorder->closing, true, __ATOMIC_RELEASE);
+    pthread_join(recorder->writer, NULL);
+
+    bool ok = !recorder->failed;
+    if (ok)
+    {
+        RecordTrailer trailer = {recorder->offset, recorder->indexCount, {0}};
+        memcpy(trailer.magic, RECORD_INDEX_MAGIC, sizeof(trailer.magic));
+        ok = WriteBytes(recorder, recorder->index, recorder->indexCount * sizeof(RecordIndexEntry)) &&
+             WriteBytes(recorder, &trailer, sizeof(trailer));
+    }
+    if (fclose(recorder->file) != 0 && ok)
+    {
+        fprintf(stderr, "Failed to write recording\n");
+        ok = false;
+    }
+    recorder->file = NULL;
+    FreeRecorderBuffers(recorder);
+    return ok;
+}
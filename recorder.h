@@ -0,0 +1,136 @@
+/******************************************************
+ * File:           recorder.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Compressed per-frame recording of boids and cell transitions, written off the sim thread
+ ******************************************************/
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include "simulation.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define RECORD_MAGIC "BOIDREC1"
+#define RECORD_INDEX_MAGIC "BOIDIDX1"
+#define RECORD_VERSION 2
+#define RECORD_RING_SLOTS 8             // Frames the sim thread may run ahead of the writer before frames are dropped
+#define RECORD_KEYFRAME_INTERVAL 256    // Recorded frames between keyframes, which list every cell that is not unburnt
+#define RECORD_IDLE_SLEEP_NS 1000000    // Writer poll interval while the ring is empty
+#define RECORD_POSITION_LEVELS 65535.0f // Positions are stored as uint16 fractions of the world extent
+#define RECORD_VELOCITY_LEVELS 127.0f   // Velocities are stored as int8 fractions of MAX_SPEED
+
+/*
+ * File layout, all little-endian as written:
+ *   RecordHeader
+ *   per recorded frame: RecordFrameHeader, then compressedSize bytes of zlib data holding
+ *     posx uint16[boidCount], posy uint16[boidCount], velx int8[boidCount], vely int8[boidCount],
+ *     flags uint8[boidCount], then transitionCount times (zigzag varint cell index delta, state byte)
+ *   RecordIndexEntry[frameCount]
+ *   RecordTrailer
+ * Cell indices are row * cols + col and each delta is from the previous transition of the frame, the
+ * first from 0. A keyframe lists every cell that is not unburnt, the others only cells that changed.
+ */
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t keyframeInterval;
+    uint32_t engine;
+    uint32_t cols;
+    uint32_t rows;
+    uint32_t reserved;
+    uint64_t seed;
+    float positionStepX;           // Pixels per uint16 position step
+    float positionStepY;
+    float velocityStep;            // Pixels per frame per int8 velocity step
+    float reserved2;
+    int32_t homeTargets[NUM_HOME_TARGETS][2]; // Pixel x and y, fixed for the whole run
+} RecordHeader;
+
+typedef struct {
+    uint64_t frame;                // Simulation frame after the step
+    uint32_t compressedSize;
+    uint32_t rawSize;
+    uint32_t boidCount;
+    uint32_t transitionCount;
+    uint32_t keyframe;             // 1 when the transitions start from an all-unburnt grid
+    uint32_t reserved;
+} RecordFrameHeader;
+
+typedef struct {
+    uint64_t frame;
+    uint64_t offset;               // Of the RecordFrameHeader from the start of the file
+    uint32_t keyframeEntry;        // Index entry of the closest keyframe at or before this one
+    uint32_t reserved;
+} RecordIndexEntry;
+
+typedef struct {
+    uint64_t indexOffset;
+    uint64_t frameCount;
+    char magic[8];
+} RecordTrailer;
+
+// Cells of one row of one chunk, states follow in the slot's data after the boid arrays
+typedef struct {
+    uint32_t row;
+    uint32_t col;
+    uint32_t width;
+} RecordSpan;
+
+// One frame handed from the sim thread to the writer, raw copies only
+typedef struct {
+    unsigned char* data;           // posx, posy, velx, vely as floats, flags, then the span states
+    size_t capacity;
+    RecordSpan* spans;
+    unsigned int spanCount;
+    unsigned int spanCapacity;
+    uint64_t frame;
+    unsigned int boidCount;
+    bool full;                     // Spans cover every cell that is not unburnt, the writer resets its mirror
+} RecordSlot;
+
+typedef struct {
+    RecordSlot slots[RECORD_RING_SLOTS];
+    unsigned int head;             // Slots published by the sim thread, only it writes this
+    unsigned int tail;             // Slots consumed by the writer, only it writes this
+    bool closing;
+    bool failed;                   // Set by the writer on a write error, later frames are dropped
+    bool needsFull;                // Next frame sends whole chunks, the first one and after long drops
+    unsigned int consecutiveDrops;
+    unsigned long long droppedFrames;
+    FILE* file;
+    pthread_t writer;
+    RecordHeader header;
+    unsigned int cols;
+    unsigned int rows;
+    unsigned int chunkCols;
+    unsigned int chunkRows;
+    unsigned char** mirror;        // Writer: per chunk slot, last recorded states or NULL while all unburnt
+    unsigned char* raw;            // Writer: frame before compression
+    size_t rawCapacity;
+    unsigned char* compressed;
+    size_t compressedCapacity;
+    RecordIndexEntry* index;       // Writer: one entry per recorded frame
+    unsigned long long indexCount;
+    unsigned long long indexCapacity;
+    unsigned int sinceKeyframe;
+    uint32_t lastKeyframeEntry;
+    uint64_t offset;               // Writer: bytes in the file so far
+} Recorder;
+
+// Opening and closing report failures on stderr and return false. The recorder must stay at the same
+// address until CloseRecorder, its writer thread points into it.
+bool OpenRecorder(Recorder* recorder, const Simulation* sim, const char* path);
+// Sim thread, after each step. Never waits on the writer, the frame is dropped when the ring is full and
+// the cell changes it carried go out with the next recorded frame.
+void RecordFrame(Recorder* recorder, Simulation* sim);
+// Drains the ring, then writes the index and trailer
+bool CloseRecorder(Recorder* recorder);
+
+#endif // RECORDER_H
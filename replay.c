@@ -0,0 +1,307 @@
+/******************************************************
+ * File:           replay.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Random access into a memory-mapped recording
+ ******************************************************/
+
+#include "replay.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+// Everything a seek relies on without looking at the frames themselves
+static bool ValidateRecording(const unsigned char* base, uint64_t fileSize)
+{
+    if (fileSize < sizeof(RecordHeader) + sizeof(RecordTrailer))
+    {
+        return false;
+    }
+
+    const RecordHeader* header = (const RecordHeader*)base;
+    if (memcmp(header->magic, RECORD_MAGIC, sizeof(header->magic)) != 0 || header->version != RECORD_VERSION ||
+        header->cols < 1 || header->rows < 1 || header->keyframeInterval < 1)
+    {
+        return false;
+    }
+
+    RecordTrailer trailer;
+    memcpy(&trailer, base + fileSize - sizeof(RecordTrailer), sizeof(trailer));
+    uint64_t indexEnd = fileSize - sizeof(RecordTrailer);
+    return memcmp(trailer.magic, RECORD_INDEX_MAGIC, sizeof(trailer.magic)) == 0 && trailer.frameCount > 0 &&
+           trailer.indexOffset >= sizeof(RecordHeader) && trailer.indexOffset <= indexEnd &&
+           (indexEnd - trailer.indexOffset) / sizeof(RecordIndexEntry) == trailer.frameCount &&
+           (indexEnd - trailer.indexOffset) % sizeof(RecordIndexEntry) == 0;
+}
+
+static bool ValidateIndex(const Replay* replay, uint64_t indexOffset)
+{
+    for (unsigned long long entry = 0; entry < replay->frameCount; entry++)
+    {
+        const RecordIndexEntry* current = &replay->index[entry];
+        if (current->offset < sizeof(RecordHeader) || current->offset > indexOffset - sizeof(RecordFrameHeader) ||
+            current->keyframeEntry > entry || replay->index[current->keyframeEntry].keyframeEntry != current->keyframeEntry ||
+            (entry > 0 && current->frame <= replay->index[entry - 1].frame))
+        {
+            return false;
+        }
+    }
+    return replay->index[0].keyframeEntry == 0;
+}
+
+bool OpenReplay(Replay* replay, const char* path)
+{
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor < 0)
+    {
+        fprintf(stderr, "Could not open recording %s\n", path);
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || status.st_size < (off_t)(sizeof(RecordHeader) + sizeof(RecordTrailer)))
+    {
+        fprintf(stderr, "Recording %s is too short\n", path);
+        close(descriptor);
+        return false;
+    }
+
+    uint64_t fileSize = (uint64_t)status.st_size;
+    const unsigned char* base = (const unsigned char*)mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (base == MAP_FAILED)
+    {
+        fprintf(stderr, "Could not map recording %s\n", path);
+        return false;
+    }
+
+    if (!ValidateRecording(base, fileSize))
+    {
+        fprintf(stderr, "Recording %s is damaged, unfinished or from another version\n", path);
+        munmap((void*)base, fileSize);
+        return false;
+    }
+
+    memset(replay, 0, sizeof(*replay));
+    replay->base = base;
+    replay->fileSize = fileSize;
+    replay->header = (const RecordHeader*)base;
+
+    RecordTrailer trailer;
+    memcpy(&trailer, base + fileSize - sizeof(RecordTrailer), sizeof(trailer));
+    replay->frameCount = trailer.frameCount;
+    replay->index = (RecordIndexEntry*)malloc(trailer.frameCount * sizeof(RecordIndexEntry));
+    if (!replay->index)
+    {
+        fprintf(stderr, "Memory allocation failed for replay index\n");
+        exit(1);
+    }
+    memcpy(replay->index, base + trailer.indexOffset, trailer.frameCount * sizeof(RecordIndexEntry));
+    if (!ValidateIndex(replay, trailer.indexOffset))
+    {
+        fprintf(stderr, "Recording %s has a damaged frame index\n", path);
+        free(replay->index);
+        munmap((void*)base, fileSize);
+        return false;
+    }
+    replay->entry = replay->frameCount;
+
+    for (unsigned int target = 0; target < NUM_HOME_TARGETS; target++)
+    {
+        replay->homeTargets[target].x = replay->header->homeTargets[target][0];
+        replay->homeTargets[target].y = replay->header->homeTargets[target][1];
+    }
+
+    InitializeViewGrid(&replay->grid, replay->header->cols, replay->header->rows);
+    return true;
+}
+
+// Back to all unburnt, live chunks are cleared in place rather than freed
+static void ClearReplayGrid(Grid* grid)
+{
+    for (unsigned int position = 0; position < grid->liveCount; position++)
+    {
+        unsigned int chunkIndex = grid->liveChunks[position];
+        memset(grid->chunks[chunkIndex].live->cells, 0, CHUNK_CELLS * sizeof(Cell));
+        unsigned int firstRow = (chunkIndex / grid->chunkCols) * CHUNK_SIZE;
+        for (unsigned int row = firstRow; row < firstRow + CHUNK_SIZE && row < grid->rows; row++)
+        {
+            MarkRowDirty(grid, row);
+        }
+    }
+}
+
+static void DecodeBoids(Replay* replay, const unsigned char* raw, unsigned int count)
+{
+    Swarm* swarm = &replay->swarm;
+    ReserveSwarm(swarm, count);
+    swarm->count = count;
+
+    const uint16_t* posx = (const uint16_t*)raw;
+    const uint16_t* posy = posx + count;
+    const int8_t* velx = (const int8_t*)(posy + count);
+    const int8_t* vely = velx + count;
+    for (unsigned int boid = 0; boid < count; boid++)
+    {
+        swarm->posx[boid] = posx[boid] * replay->header->positionStepX;
+        swarm->posy[boid] = posy[boid] * replay->header->positionStepY;
+        swarm->velx[boid] = velx[boid] * replay->header->velocityStep;
+        swarm->vely[boid] = vely[boid] * replay->header->velocityStep;
+    }
+    memcpy(swarm->flags, vely + count, count);
+}
+
+// Applies one recorded frame on top of the grid, boids are only decoded for the frame that is shown
+static bool ApplyFrame(Replay* replay, unsigned long long entry, bool decodeBoids)
+{
+    const RecordIndexEntry* indexEntry = &replay->index[entry];
+    RecordFrameHeader frame;
+    memcpy(&frame, replay->base + indexEntry->offset, sizeof(frame));
+    uint64_t dataOffset = indexEntry->offset + sizeof(frame);
+    uint64_t indexOffset = replay->fileSize - sizeof(RecordTrailer) - replay->frameCount * sizeof(RecordIndexEntry);
+    if (frame.frame != indexEntry->frame || frame.compressedSize > indexOffset - dataOffset ||
+        (uint64_t)frame.boidCount * 7 > frame.rawSize || frame.keyframe != (indexEntry->keyframeEntry == entry))
+    {
+        fprintf(stderr, "Recorded frame %llu is damaged\n", (unsigned long long)indexEntry->frame);
+        return false;
+    }
+
+    if (frame.rawSize > replay->rawCapacity)
+    {
+        unsigned char* raw = (unsigned char*)realloc(replay->raw, frame.rawSize);
+        if (!raw)
+        {
+            fprintf(stderr, "Memory allocation failed for replay frame\n");
+            exit(1);
+        }
+        replay->raw = raw;
+        replay->rawCapacity = frame.rawSize;
+    }
+    uLongf rawSize = frame.rawSize;
+    if (uncompress(replay->raw, &rawSize, replay->base + dataOffset, frame.compressedSize) != Z_OK ||
+        rawSize != frame.rawSize)
+    {
+        fprintf(stderr, "Recorded frame %llu is damaged\n", (unsigned long long)indexEntry->frame);
+        return false;
+    }
+
+    Grid* grid = &replay->grid;
+    if (frame.keyframe)
+    {
+        ClearReplayGrid(grid);
+    }
+
+    const unsigned char* in = replay->raw + (size_t)frame.boidCount * 7;
+    const unsigned char* end = replay->raw + rawSize;
+    uint64_t cell = 0;
+    uint64_t cellCount = (uint64_t)grid->rows * grid->cols;
+    for (uint32_t transition = 0; transition < frame.transitionCount; transition++)
+    {
+        uint64_t zigzag = 0;
+        unsigned int shift = 0;
+        while (in < end && (*in & 0x80) && shift < 63)
+        {
+            zigzag |= (uint64_t)(*in++ & 0x7F) << shift;
+            shift += 7;
+        }
+        if (end - in < 2)
+        {
+            fprintf(stderr, "Recorded frame %llu is damaged\n", (unsigned long long)indexEntry->frame);
+            return false;
+        }
+        zigzag |= (uint64_t)*in++ << shift;
+        cell += (uint64_t)((int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1));
+        unsigned char state = *in++;
+        if (cell >= cellCount || state >= CELL_STATE_COUNT)
+        {
+            fprintf(stderr, "Recorded frame %llu is damaged\n", (unsigned long long)indexEntry->frame);
+            return false;
+        }
+
+        unsigned int row = (unsigned int)(cell / grid->cols);
+        unsigned int col = (unsigned int)(cell % grid->cols);
+        GetCell(grid, row, col)->state = state;
+        MarkRowDirty(grid, row);
+    }
+
+    if (decodeBoids)
+    {
+        DecodeBoids(replay, replay->raw, frame.boidCount);
+    }
+    return true;
+}
+
+// At most keyframeInterval frames are applied: forward from the current frame when no keyframe lies in
+// between, otherwise from the target's keyframe
+bool SeekReplay(Replay* replay, unsigned long long entry)
+{
+    if (entry >= replay->frameCount)
+    {
+        entry = replay->frameCount - 1;
+    }
+    if (entry == replay->entry)
+    {
+        return true;
+    }
+
+    unsigned long long first = replay->index[entry].keyframeEntry;
+    if (replay->entry < entry && replay->entry >= first)
+    {
+        first = replay->entry + 1;
+    }
+
+    replay->entry = replay->frameCount;
+    for (unsigned long long current = first; current <= entry; current++)
+    {
+        if (!ApplyFrame(replay, current, current == entry))
+        {
+            return false;
+        }
+    }
+    replay->entry = entry;
+    return true;
+}
+
+unsigned long long FindReplayEntry(const Replay* replay, unsigned long long frame)
+{
+    // Without dropped frames entries and frames line up, otherwise binary search
+    unsigned long long guess = frame - replay->index[0].frame;
+    if (frame >= replay->index[0].frame && guess < replay->frameCount && replay->index[guess].frame == frame)
+    {
+        return guess;
+    }
+
+    unsigned long long low = 0;
+    unsigned long long high = replay->frameCount;
+    while (high - low > 1)
+    {
+        unsigned long long middle = low + (high - low) / 2;
+        if (replay->index[middle].frame <= frame)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void CloseReplay(Replay* replay)
+{
+    FreeViewGrid(&replay->grid);
+    FreeSwarm(&replay->swarm);
+    free(replay->raw);
+    free(replay->index);
+    munmap((void*)replay->base, replay->fileSize);
+    memset(replay, 0, sizeof(*replay));
+}
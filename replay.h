@@ -0,0 +1,42 @@
+/******************************************************
+ * File:           replay.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Random access into a memory-mapped recording
+ ******************************************************/
+
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "recorder.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// A recording opened for playback. Grid and swarm hold the frame last seeked to in the layout the renderer
+// reads; the grid is a view grid, nothing here steps a simulation.
+typedef struct {
+    const unsigned char* base;     // Whole file, mapped read-only
+    uint64_t fileSize;
+    const RecordHeader* header;
+    RecordIndexEntry* index;       // Copied out of the file, entries land at unaligned offsets
+    unsigned long long frameCount; // Entries in the index
+    unsigned long long entry;      // Entry grid and swarm show, frameCount until the first seek
+    Grid grid;
+    Swarm swarm;
+    HomeTarget homeTargets[NUM_HOME_TARGETS];
+    unsigned char* raw;            // Scratch: one decompressed frame
+    size_t rawCapacity;
+} Replay;
+
+// Both report failures on stderr and return false. A failed seek leaves the replay at an unspecified frame.
+bool OpenReplay(Replay* replay, const char* path);
+bool SeekReplay(Replay* replay, unsigned long long entry);
+// Entry of the last recorded frame at or before frame, 0 if frame precedes the recording
+unsigned long long FindReplayEntry(const Replay* replay, unsigned long long frame);
+void CloseReplay(Replay* replay);
+
+#endif // REPLAY_H
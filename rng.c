@@ -0,0 +1,90 @@
+/******************************************************
+ * File:           rng.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Seedable counter-based random streams
+ ******************************************************/
+
+#include "rng.h"
+
+static uint64_t rngSeed = 0;
+static unsigned int rngGeneration = 1;  // Bumped on reseed so thread streams start over
+
+// Streams of the calling thread, set up lazily from the current seed
+static _Thread_local RngStream threadStreams[RNG_STREAM_COUNT];
+static _Thread_local unsigned int threadGeneration = 0;
+static _Thread_local unsigned int threadIndex = 0;
+
+// Call before worker threads start, streams already handed out keep their old key
+void SeedRandom(uint64_t seed)
+{
+    rngSeed = seed;
+    rngGeneration++;
+}
+
+uint64_t GetRandomSeed(void)
+{
+    return rngSeed;
+}
+
+// Worker threads pick distinct indices so their streams do not overlap, the main thread is 0
+void SetRngThread(unsigned int thread)
+{
+    threadIndex = thread;
+    threadGeneration = 0;
+}
+
+RngStream* GetRngStream(RngSubsystem subsystem)
+{
+    if (threadGeneration != rngGeneration)
+    {
+        for (unsigned int index = 0; index < RNG_STREAM_COUNT; index++)
+        {
+            InitializeRngStream(&threadStreams[index], rngSeed, index, threadIndex);
+        }
+        threadGeneration = rngGeneration;
+    }
+    return &threadStreams[subsystem];
+}
+
+uint64_t RngStreamKey(uint64_t seed, unsigned int subsystem, unsigned int thread)
+{
+    // Hash twice so nearby seeds, subsystems and threads land on unrelated keys
+    uint64_t stream = ((uint64_t)subsystem << 32) | thread;
+    return RngAt(RngAt(seed, 0), stream + 1);
+}
+
+void InitializeRngStream(RngStream* stream, uint64_t seed, unsigned int subsystem, unsigned int thread)
+{
+    stream->key = RngStreamKey(seed, subsystem, thread);
+    stream->counter = 0;
+}
+
+void RngFillUniform(RngStream* stream, float* out, unsigned int count, float min, float max)
+{
+    uint64_t key = stream->key;
+    uint64_t counter = stream->counter;
+    float scale = max - min;
+
+    // Independent iterations, so the compiler can vectorize the hash
+    for (unsigned int index = 0; index < count; index++)
+    {
+        out[index] = min + RngToUnit(RngAt(key, counter + index)) * scale;
+    }
+    stream->counter = counter + count;
+}
+
+void RngFillBits(RngStream* stream, uint64_t* out, unsigned int count)
+{
+    uint64_t key = stream->key;
+    uint64_t counter = stream->counter;
+
+    for (unsigned int index = 0; index < count; index++)
+    {
+        out[index] = RngAt(key, counter + index);
+    }
+    stream->counter = counter + count;
+}
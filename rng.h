@@ -0,0 +1,68 @@
+/******************************************************
+ * File:           rng.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Seedable counter-based random streams
+ ******************************************************/
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Each subsystem draws from its own stream, so adding draws in one does not shift the others
+typedef enum {
+    RNG_STREAM_INIT,      // Initial swarm
+    RNG_STREAM_SPAWN,     // Boids added during the run
+    RNG_STREAM_SCHEDULE,  // Spread probability schedule and swarm trimming
+    RNG_STREAM_SPREAD,    // Fire spreading to neighbors
+    RNG_STREAM_IGNITION,  // Random ignitions
+    RNG_STREAM_COUNT
+} RngSubsystem;
+
+// Output n of a stream is RngAt(key, n), so a stream can be split or jumped without generating the skipped values
+typedef struct {
+    uint64_t key;
+    uint64_t counter;
+} RngStream;
+
+void SeedRandom(uint64_t seed);
+uint64_t GetRandomSeed(void);
+void SetRngThread(unsigned int thread);
+RngStream* GetRngStream(RngSubsystem subsystem);
+
+uint64_t RngStreamKey(uint64_t seed, unsigned int subsystem, unsigned int thread);
+void InitializeRngStream(RngStream* stream, uint64_t seed, unsigned int subsystem, unsigned int thread);
+
+// splitmix64 finalizer over key + counter, stateless so any thread can draw value n of any stream
+static inline uint64_t RngAt(uint64_t key, uint64_t counter)
+{
+    uint64_t z = key + counter * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t RngNext(RngStream* stream)
+{
+    return RngAt(stream->key, stream->counter++);
+}
+
+// Uniform in [0, 1) from the top 24 bits, every value is exactly representable
+static inline float RngToUnit(uint64_t bits)
+{
+    return (float)(bits >> 40) * (1.0f / 16777216.0f);
+}
+
+static inline float RngUniform(RngStream* stream)
+{
+    return RngToUnit(RngNext(stream));
+}
+
+void RngFillUniform(RngStream* stream, float* out, unsigned int count, float min, float max);
+void RngFillBits(RngStream* stream, uint64_t* out, unsigned int count);
+
+#endif
@@ -0,0 +1,239 @@
+/******************************************************
+ * File:           section_pyramid.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Max pyramid over section intensities for target-section search
+ ******************************************************/
+
+#include "section_pyramid.h"
+#include "constants.h"
+#include "utils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void InitializeSectionPyramid(SectionPyramid* pyramid, unsigned int numSectionsX, unsigned int numSectionsY,
+                              unsigned int gridCols, unsigned int gridRows)
+{
+    *pyramid = (SectionPyramid){0};
+    pyramid->sectionCols = gridCols / numSectionsX;
+    pyramid->sectionRows = gridRows / numSectionsY;
+
+    unsigned int width = numSectionsX;
+    unsigned int height = numSectionsY;
+    for (;;)
+    {
+        unsigned int level = pyramid->levelCount++;
+        pyramid->widths[level] = width;
+        pyramid->heights[level] = height;
+        pyramid->levels[level] = (float*)calloc(width * height, sizeof(float));
+        if (!pyramid->levels[level])
+        {
+            fprintf(stderr, "Memory allocation failed for section pyramid\n");
+            exit(1);
+        }
+
+        if (width == 1 && height == 1)
+        {
+            break;
+        }
+        width = (width + 1) / 2;
+        height = (height + 1) / 2;
+    }
+}
+
+// Copies the section intensities in and takes the max of each 2x2 block up to the single top node
+void BuildSectionPyramid(SectionPyramid* pyramid, float** sectionIntensity)
+{
+    float* base = pyramid->levels[0];
+    for (unsigned int sectionY = 0; sectionY < pyramid->heights[0]; sectionY++)
+    {
+        for (unsigned int sectionX = 0; sectionX < pyramid->widths[0]; sectionX++)
+        {
+            base[sectionY * pyramid->widths[0] + sectionX] = sectionIntensity[sectionX][sectionY];
+        }
+    }
+
+    for (unsigned int level = 1; level < pyramid->levelCount; level++)
+    {
+        const float* below = pyramid->levels[level - 1];
+        unsigned int belowWidth = pyramid->widths[level - 1];
+        unsigned int belowHeight = pyramid->heights[level - 1];
+        float* nodes = pyramid->levels[level];
+
+        for (unsigned int nodeY = 0; nodeY < pyramid->heights[level]; nodeY++)
+        {
+            for (unsigned int nodeX = 0; nodeX < pyramid->widths[level]; nodeX++)
+            {
+                float highest = below[(nodeY * 2) * belowWidth + nodeX * 2];
+                if (nodeX * 2 + 1 < belowWidth)
+                {
+                    highest = fmaxf(highest, below[(nodeY * 2) * belowWidth + nodeX * 2 + 1]);
+                }
+                if (nodeY * 2 + 1 < belowHeight)
+                {
+                    highest = fmaxf(highest, below[(nodeY * 2 + 1) * belowWidth + nodeX * 2]);
+                    if (nodeX * 2 + 1 < belowWidth)
+                    {
+                        highest = fmaxf(highest, below[(nodeY * 2 + 1) * belowWidth + nodeX * 2 + 1]);
+                    }
+                }
+                nodes[nodeY * pyramid->widths[level] + nodeX] = highest;
+            }
+        }
+    }
+}
+
+typedef struct {
+    const SectionPyramid* pyramid;
+    float x, y;
+    float best;
+    int bestX, bestY;
+} SectionSearch;
+
+static float SectionCenter(unsigned int section, unsigned int sectionCells)
+{
+    return (section + 0.5f) * sectionCells * CELL_SIZE;
+}
+
+// Weighted intensity of one section, intensity over the clamped distance to its center
+static float WeighSection(const SectionSearch* search, unsigned int sectionX, unsigned int sectionY)
+{
+    const SectionPyramid* pyramid = search->pyramid;
+    float distance = EuclideanDistance(SectionCenter(sectionX, pyramid->sectionCols),
+                                       SectionCenter(sectionY, pyramid->sectionRows), search->x, search->y);
+    if (distance < SECTION_MIN_DISTANCE)
+    {
+        distance = SECTION_MIN_DISTANCE;
+    }
+    return pyramid->levels[0][sectionY * pyramid->widths[0] + sectionX] * (1.0f / distance);
+}
+
+// Upper bound on the weighted intensity of any section under a node: its max intensity over the distance
+// to the box around its section centers. Float rounding is monotonic, so the bound is never below a real score.
+static float BoundNode(const SectionSearch* search, unsigned int level, unsigned int nodeX, unsigned int nodeY)
+{
+    const SectionPyramid* pyramid = search->pyramid;
+    unsigned int firstX = nodeX << level;
+    unsigned int firstY = nodeY << level;
+    unsigned int lastX = ((nodeX + 1) << level) - 1;
+    unsigned int lastY = ((nodeY + 1) << level) - 1;
+    if (lastX >= pyramid->widths[0]) lastX = pyramid->widths[0] - 1;
+    if (lastY >= pyramid->heights[0]) lastY = pyramid->heights[0] - 1;
+
+    float minX = SectionCenter(firstX, pyramid->sectionCols);
+    float maxX = SectionCenter(lastX, pyramid->sectionCols);
+    float minY = SectionCenter(firstY, pyramid->sectionRows);
+    float maxY = SectionCenter(lastY, pyramid->sectionRows);
+    float closestX = (search->x < minX) ? minX : (search->x > maxX) ? maxX : search->x;
+    float closestY = (search->y < minY) ? minY : (search->y > maxY) ? maxY : search->y;
+
+    float distance = EuclideanDistance(closestX, closestY, search->x, search->y);
+    if (distance < SECTION_MIN_DISTANCE)
+    {
+        distance = SECTION_MIN_DISTANCE;
+    }
+    return pyramid->levels[level][nodeY * pyramid->widths[level] + nodeX] * (1.0f / distance);
+}
+
+// Ties go to the lowest sectionX, then sectionY, the order a plain scan over the sections would keep
+static void VisitSection(SectionSearch* search, unsigned int sectionX, unsigned int sectionY)
+{
+    float weighted = WeighSection(search, sectionX, sectionY);
+    if (weighted > search->best ||
+        (weighted == search->best && ((int)sectionX < search->bestX ||
+                                      ((int)sectionX == search->bestX && (int)sectionY < search->bestY))))
+    {
+        search->best = weighted;
+        search->bestX = sectionX;
+        search->bestY = sectionY;
+    }
+}
+
+// Depth first, children in order of their bounds, skipping any whose bound cannot beat the best so far
+static void VisitNode(SectionSearch* search, unsigned int level, unsigned int nodeX, unsigned int nodeY)
+{
+    const SectionPyramid* pyramid = search->pyramid;
+    unsigned int childLevel = level - 1;
+    unsigned int childX[4], childY[4];
+    float childBound[4];
+    unsigned int childCount = 0;
+
+    for (unsigned int offsetY = 0; offsetY < 2; offsetY++)
+    {
+        for (unsigned int offsetX = 0; offsetX < 2; offsetX++)
+        {
+            unsigned int x = nodeX * 2 + offsetX;
+            unsigned int y = nodeY * 2 + offsetY;
+            if (x >= pyramid->widths[childLevel] || y >= pyramid->heights[childLevel])
+            {
+                continue;
+            }
+
+            float bound = BoundNode(search, childLevel, x, y);
+            unsigned int slot = childCount++;
+            while (slot > 0 && childBound[slot - 1] < bound)
+            {
+                childX[slot] = childX[slot - 1];
+                childY[slot] = childY[slot - 1];
+                childBound[slot] = childBound[slot - 1];
+                slot--;
+            }
+            childX[slot] = x;
+            childY[slot] = y;
+            childBound[slot] = bound;
+        }
+    }
+
+    for (unsigned int child = 0; child < childCount; child++)
+    {
+        if (childBound[child] <= 0.0f || childBound[child] < search->best)
+        {
+            break;  // Sorted, so no later child can do better either
+        }
+        if (childLevel == 0)
+        {
+            VisitSection(search, childX[child], childY[child]);
+        }
+        else
+        {
+            VisitNode(search, childLevel, childX[child], childY[child]);
+        }
+    }
+}
+
+// Section with the highest intensity over distance from (x, y), in screen pixels. Returns the weighted
+// intensity, or 0 with the section left at -1 when no section has any intensity.
+float FindTargetSection(const SectionPyramid* pyramid, float x, float y, int* sectionX, int* sectionY)
+{
+    SectionSearch search = {pyramid, x, y, 0.0f, -1, -1};
+    unsigned int top = pyramid->levelCount - 1;
+
+    if (top == 0)
+    {
+        if (pyramid->levels[0][0] > 0.0f)
+        {
+            VisitSection(&search, 0, 0);
+        }
+    }
+    else if (pyramid->levels[top][0] > 0.0f)
+    {
+        VisitNode(&search, top, 0, 0);
+    }
+
+    *sectionX = search.bestX;
+    *sectionY = search.bestY;
+    return search.best;
+}
+
+void FreeSectionPyramid(SectionPyramid* pyramid)
+{
+    for (unsigned int level = 0; level < pyramid->levelCount; level++)
+    {
+        free(pyramid->levels[level]);
+    }
+    *pyramid = (SectionPyramid){0};
+}
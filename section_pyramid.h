@@ -0,0 +1,33 @@
+/******************************************************
+ * File:           section_pyramid.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Max pyramid over section intensities for target-section search
+ ******************************************************/
+
+#ifndef SECTION_PYRAMID_H
+#define SECTION_PYRAMID_H
+
+#define SECTION_PYRAMID_MAX_LEVELS 32
+#define SECTION_MIN_DISTANCE 50.0f  // Boids closer than this to a section center weigh it as if this far
+
+// Level 0 holds one intensity per section, each level above holds the max of up to 2x2 nodes below
+typedef struct {
+    float* levels[SECTION_PYRAMID_MAX_LEVELS];   // Row-major, y * widths[level] + x
+    unsigned int widths[SECTION_PYRAMID_MAX_LEVELS];
+    unsigned int heights[SECTION_PYRAMID_MAX_LEVELS];
+    unsigned int levelCount;                     // The top level is a single node
+    unsigned int sectionCols;                    // Grid cells per section
+    unsigned int sectionRows;
+} SectionPyramid;
+
+void InitializeSectionPyramid(SectionPyramid* pyramid, unsigned int numSectionsX, unsigned int numSectionsY,
+                              unsigned int gridCols, unsigned int gridRows);
+void BuildSectionPyramid(SectionPyramid* pyramid, float** sectionIntensity);
+float FindTargetSection(const SectionPyramid* pyramid, float x, float y, int* sectionX, int* sectionY);
+void FreeSectionPyramid(SectionPyramid* pyramid);
+
+#endif // SECTION_PYRAMID_H
@@ -0,0 +1,234 @@
+/******************************************************
+ * File:           sim_thread.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Fixed-timestep simulation thread publishing snapshots to a renderer
+ ******************************************************/
+
+#include "sim_thread.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static void PublishSnapshot(SimThread* thread)
+{
+    Simulation* sim = thread->sim;
+    Grid* grid = &sim->grid;
+    thread->step++;
+
+    // The sim thread is the grid's only render reader now, it turns the dirty bits into publish steps
+    for (unsigned int row = 0; row < grid->rows; row++)
+    {
+        if (grid->dirtyRows[row] & DIRTY_ROW_RENDER)
+        {
+            grid->dirtyRows[row] &= ~DIRTY_ROW_RENDER;
+            thread->rowSteps[row] = thread->step;
+        }
+    }
+
+    // Only rows that changed since this buffer was last written, it may be a few steps behind
+    SimSnapshot* snapshot = &thread->snapshots[thread->back];
+    for (unsigned int row = 0; row < grid->rows; row++)
+    {
+        if (thread->rowSteps[row] > snapshot->step)
+        {
+            unsigned char* cells = snapshot->cells + (size_t)row * grid->cols;
+            for (unsigned int col = 0; col < grid->cols; col++)
+            {
+                cells[col] = GetCellState(grid, row, col);
+            }
+        }
+    }
+    memcpy(snapshot->rowSteps, thread->rowSteps, grid->rows * sizeof(uint64_t));
+
+    const Swarm* swarm = &sim->swarm;
+    ReserveSwarm(&snapshot->swarm, swarm->count);
+    snapshot->swarm.count = swarm->count;
+    memcpy(snapshot->swarm.posx, swarm->posx, swarm->count * sizeof(float));
+    memcpy(snapshot->swarm.posy, swarm->posy, swarm->count * sizeof(float));
+    memcpy(snapshot->swarm.velx, swarm->velx, swarm->count * sizeof(float));
+    memcpy(snapshot->swarm.vely, swarm->vely, swarm->count * sizeof(float));
+    memcpy(snapshot->swarm.flags, swarm->flags, swarm->count);
+
+    snapshot->step = thread->step;
+    snapshot->frame = sim->frame;
+    snapshot->time = GetTimeSeconds();
+    thread->back = __atomic_exchange_n(&thread->middle, thread->back | SNAPSHOT_FRESH, __ATOMIC_ACQ_REL) &
+                   SNAPSHOT_INDEX_MASK;
+}
+
+static void RunCommands(SimThread* thread)
+{
+    unsigned int head = __atomic_load_n(&thread->commandHead, __ATOMIC_ACQUIRE);
+    for (unsigned int tail = thread->commandTail; tail != head; tail++)
+    {
+        const SimCommand* command = &thread->commands[tail % SIM_COMMAND_SLOTS];
+        if (command->type == SIM_COMMAND_IGNITE)
+        {
+            IgniteAtPoint(thread->sim, command->x, command->y);
+        }
+    }
+    __atomic_store_n(&thread->commandTail, head, __ATOMIC_RELEASE);
+}
+
+static void SleepUntil(double deadline)
+{
+    double remaining = deadline - GetTimeSeconds();
+    if (remaining > 0)
+    {
+        struct timespec duration = {(time_t)remaining, (long)((remaining - (time_t)remaining) * 1e9)};
+        nanosleep(&duration, NULL);
+    }
+}
+
+// Steps on a fixed schedule. A step that runs long pushes the next ones back to back until the schedule
+// is caught up; past SIM_MAX_LAG_STEPS behind, the schedule restarts from now instead of bursting.
+static void* SimThreadMain(void* argument)
+{
+    SimThread* thread = (SimThread*)argument;
+    double nextStep = GetTimeSeconds() + thread->stepSeconds;
+
+    while (!__atomic_load_n(&thread->stopping, __ATOMIC_ACQUIRE))
+    {
+        SleepUntil(nextStep);
+
+        RunCommands(thread);
+        StepSimulation(thread->sim, 1);
+        if (thread->recorder)
+        {
+            RecordFrame(thread->recorder, thread->sim);
+        }
+        if (thread->publisher)
+        {
+            PublishFrame(thread->publisher, thread->sim);
+        }
+        PublishSnapshot(thread);
+
+        nextStep += thread->stepSeconds;
+        double now = GetTimeSeconds();
+        if (now - nextStep > SIM_MAX_LAG_STEPS * thread->stepSeconds)
+        {
+            nextStep = now;
+        }
+    }
+    return NULL;
+}
+
+void StartSimThread(SimThread* thread, Simulation* sim, Recorder* recorder, Publisher* publisher, unsigned int stepRate)
+{
+    memset(thread, 0, sizeof(*thread));
+    thread->sim = sim;
+    thread->recorder = recorder;
+    thread->publisher = publisher;
+    thread->stepSeconds = 1.0 / stepRate;
+    thread->back = 0;
+    thread->middle = 1;
+    thread->front = 2;
+
+    const Grid* grid = &sim->grid;
+    thread->rowSteps = (uint64_t*)calloc(grid->rows, sizeof(uint64_t));
+    for (unsigned int buffer = 0; buffer < 3; buffer++)
+    {
+        thread->snapshots[buffer].cells = (unsigned char*)calloc((size_t)grid->rows * grid->cols, 1);
+        thread->snapshots[buffer].rowSteps = (uint64_t*)calloc(grid->rows, sizeof(uint64_t));
+        if (!thread->snapshots[buffer].cells || !thread->snapshots[buffer].rowSteps)
+        {
+            fprintf(stderr, "Memory allocation failed for simulation snapshots\n");
+            exit(1);
+        }
+    }
+    if (!thread->rowSteps)
+    {
+        fprintf(stderr, "Memory allocation failed for simulation snapshots\n");
+        exit(1);
+    }
+
+    // The renderer always has a snapshot to draw, even before the first step
+    PublishSnapshot(thread);
+
+    if (pthread_create(&thread->handle, NULL, SimThreadMain, thread) != 0)
+    {
+        fprintf(stderr, "Thread creation failed for simulation thread\n");
+        exit(1);
+    }
+}
+
+void StopSimThread(SimThread* thread)
+{
+    __atomic_store_n(&thread->stopping, true, __ATOMIC_RELEASE);
+    pthread_join(thread->handle, NULL);
+
+    for (unsigned int buffer = 0; buffer < 3; buffer++)
+    {
+        FreeSwarm(&thread->snapshots[buffer].swarm);
+        free(thread->snapshots[buffer].cells);
+        free(thread->snapshots[buffer].rowSteps);
+    }
+    free(thread->rowSteps);
+    thread->rowSteps = NULL;
+}
+
+bool PushSimCommand(SimThread* thread, SimCommand command)
+{
+    unsigned int head = thread->commandHead;
+    if (head - __atomic_load_n(&thread->commandTail, __ATOMIC_ACQUIRE) == SIM_COMMAND_SLOTS)
+    {
+        return false;
+    }
+    thread->commands[head % SIM_COMMAND_SLOTS] = command;
+    __atomic_store_n(&thread->commandHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Swaps the drawn buffer for the published one when there is a newer one, otherwise keeps drawing the same
+const SimSnapshot* AcquireSnapshot(SimThread* thread)
+{
+    if (__atomic_load_n(&thread->middle, __ATOMIC_ACQUIRE) & SNAPSHOT_FRESH)
+    {
+        thread->front = __atomic_exchange_n(&thread->middle, thread->front, __ATOMIC_ACQ_REL) & SNAPSHOT_INDEX_MASK;
+    }
+    return &thread->snapshots[thread->front];
+}
+
+void UpdateViewGrid(const SimSnapshot* snapshot, Grid* view, uint64_t* viewStep)
+{
+    for (unsigned int row = 0; row < view->rows; row++)
+    {
+        if (snapshot->rowSteps[row] <= *viewStep)
+        {
+            continue;
+        }
+        const unsigned char* cells = snapshot->cells + (size_t)row * view->cols;
+        for (unsigned int col = 0; col < view->cols; col++)
+        {
+            GetCell(view, row, col)->state = cells[col];
+        }
+        MarkRowDirty(view, row);
+    }
+    *viewStep = snapshot->step;
+}
+
+// Integration moves every boid by its velocity last in a step, so the position one step earlier is the
+// current one minus the velocity
+void InterpolateSnapshot(const SimThread* thread, const SimSnapshot* snapshot, double now, Swarm* swarm)
+{
+    double progress = (now - snapshot->time) / thread->stepSeconds;
+    float behind = 1.0f - (float)(progress < 0 ? 0 : (progress > 1 ? 1 : progress));
+
+    const Swarm* source = &snapshot->swarm;
+    ReserveSwarm(swarm, source->count);
+    swarm->count = source->count;
+    for (unsigned int index = 0; index < source->count; index++)
+    {
+        swarm->posx[index] = source->posx[index] - source->velx[index] * behind;
+        swarm->posy[index] = source->posy[index] - source->vely[index] * behind;
+    }
+    memcpy(swarm->velx, source->velx, source->count * sizeof(float));
+    memcpy(swarm->vely, source->vely, source->count * sizeof(float));
+    memcpy(swarm->flags, source->flags, source->count);
+}
@@ -0,0 +1,77 @@
+/******************************************************
+ * File:           sim_thread.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Fixed-timestep simulation thread publishing snapshots to a renderer
+ ******************************************************/
+
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "simulation.h"
+#include "recorder.h"
+#include "publisher.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SIM_COMMAND_SLOTS 256       // Commands the renderer may queue ahead of the sim thread
+#define SIM_MAX_LAG_STEPS 4         // Steps the sim may fall behind its schedule before the schedule restarts
+#define SNAPSHOT_FRESH 0x4u         // Set in SimThread.middle while the renderer has not taken the snapshot
+#define SNAPSHOT_INDEX_MASK 0x3u
+
+typedef enum {
+    SIM_COMMAND_IGNITE              // Set the cell under screen point x, y alight
+} SimCommandType;
+
+typedef struct {
+    SimCommandType type;
+    int x;
+    int y;
+} SimCommand;
+
+// What the renderer needs from one step
+typedef struct {
+    Swarm swarm;                    // Positions and velocities after the step, energy is not copied
+    unsigned char* cells;           // Cell states, row * cols + col
+    uint64_t* rowSteps;             // Per row, publish step of the last change
+    uint64_t step;                  // Publish step this buffer holds, 0 before its first use
+    unsigned long long frame;       // Simulation frame
+    double time;                    // GetTimeSeconds when it was published
+} SimSnapshot;
+
+typedef struct {
+    Simulation* sim;                // Owned by the sim thread while it runs
+    Recorder* recorder;             // Optional, fed after every step
+    Publisher* publisher;           // Optional, fed after every step
+    pthread_t handle;
+    bool stopping;
+    double stepSeconds;
+    SimCommand commands[SIM_COMMAND_SLOTS];
+    unsigned int commandHead;       // Pushed by the renderer, only it writes this
+    unsigned int commandTail;       // Taken by the sim thread, only it writes this
+    SimSnapshot snapshots[3];       // Triple buffer, one being written, one published, one being drawn
+    unsigned int back;              // Sim thread: buffer being written
+    unsigned int middle;            // Latest published buffer, with SNAPSHOT_FRESH until taken
+    unsigned int front;             // Renderer: buffer being drawn
+    uint64_t* rowSteps;             // Sim thread: per row, publish step of the last change
+    uint64_t step;                  // Sim thread: snapshots published so far
+} SimThread;
+
+// Publishes the starting state, then steps sim stepRate times a second until StopSimThread. The thread
+// must stay at the same address until then. Nothing else may touch sim while it runs.
+void StartSimThread(SimThread* thread, Simulation* sim, Recorder* recorder, Publisher* publisher, unsigned int stepRate);
+void StopSimThread(SimThread* thread);
+
+// Renderer side. Never wait on the sim thread: a full command queue drops the command.
+bool PushSimCommand(SimThread* thread, SimCommand command);
+const SimSnapshot* AcquireSnapshot(SimThread* thread);
+// Copies the rows that changed since viewStep into a view grid and advances viewStep
+void UpdateViewGrid(const SimSnapshot* snapshot, Grid* view, uint64_t* viewStep);
+// Boids at display time now, drawn one step behind the simulation so they move between two real steps
+void InterpolateSnapshot(const SimThread* thread, const SimSnapshot* snapshot, double now, Swarm* swarm);
+
+#endif // SIM_THREAD_H
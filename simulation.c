@@ -0,0 +1,319 @@
+/******************************************************
+ * File:           simulation.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Headless simulation state and stepping
+ ******************************************************/
+
+#include "simulation.h"
+#include "utils.h"
+#include "rng.h"
+#include "profile.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+void InitializeSimulation(Simulation* sim, uint64_t seed, FireEngine engine, unsigned int cols, unsigned int rows)
+{
+    InitializeSimulationThreads(sim, seed, engine, cols, rows, NUM_THREADS);
+}
+
+void InitializeSimulationThreads(Simulation* sim, uint64_t seed, FireEngine engine, unsigned int cols, unsigned int rows,
+                                 unsigned int threadCount)
+{
+    *sim = (Simulation){0};
+    sim->seed = seed;
+    SeedRandom(seed);
+    sim->worldWidth = (float)cols * CELL_SIZE;
+    sim->worldHeight = (float)rows * CELL_SIZE;
+
+    // Set number of boids to start and sections of map, tiny worlds get one section per cell
+    sim->numSectionsX = (NUM_SECTIONS_X < cols) ? NUM_SECTIONS_X : cols;
+    sim->numSectionsY = (NUM_SECTIONS_Y < rows) ? NUM_SECTIONS_Y : rows;
+
+    sim->minBoids = MIN_BOID_NUM;
+    sim->maxBoids = MAX_BOID_NUM;
+    sim->spawnFactor = SPAWN_FACTOR;
+    sim->maxForceTarget = MAX_FORCE_TARGET;
+    InitializeSwarm(&sim->swarm, sim->minBoids, sim->worldWidth, sim->worldHeight);
+    ReserveSwarm(&sim->swarm, sim->maxBoids + NUM_HOME_TARGETS);  // Spawning adds one boid per home target
+
+    // Define home targets, laid out for the screen and stretched over larger worlds
+    const HomeTarget homeTargets[NUM_HOME_TARGETS] = {
+        {200, 100},
+        {1600, 100},
+        {200, 900},
+        {1500, 600},
+    };
+    for (unsigned int index = 0; index < NUM_HOME_TARGETS; index++)
+    {
+        sim->homeTargets[index].x = (int)((double)homeTargets[index].x * sim->worldWidth / SCREEN_WIDTH);
+        sim->homeTargets[index].y = (int)((double)homeTargets[index].y * sim->worldHeight / SCREEN_HEIGHT);
+    }
+
+    InitializeGrid(&sim->grid, engine, cols, rows, sim->numSectionsX, sim->numSectionsY);
+    InitializeSpatialHash(&sim->hash, NEIGHBOR_CELL_SIZE, sim->worldWidth, sim->worldHeight);
+    InitializeFireField(&sim->fireField, &sim->grid);
+    InitializeSectionPyramid(&sim->sectionPyramid, sim->numSectionsX, sim->numSectionsY, sim->grid.cols, sim->grid.rows);
+    InitializeThreadPool(&sim->pool, threadCount);
+    sim->grid.pool = &sim->pool;
+
+    // Initialize spreadProbability and randomness control variables
+    sim->spreadProbability = MIN_SPREAD_PROBABILITY;
+    sim->updateFrequency = MIN_SPREAD_FREQ_COUNT;
+
+    // Allocate memory for sectionIntensity
+    sim->sectionIntensity = (float **)malloc(sim->numSectionsX * sizeof(float *));
+    if (!sim->sectionIntensity)
+    {
+        fprintf(stderr, "Memory allocation failed for section intensity\n");
+        exit(1);
+    }
+    for (unsigned int index = 0; index < sim->numSectionsX; index++)
+    {
+        sim->sectionIntensity[index] = (float *)calloc(sim->numSectionsY, sizeof(float));
+        if (!sim->sectionIntensity[index])
+        {
+            fprintf(stderr, "Memory allocation failed for section intensity\n");
+            exit(1);
+        }
+    }
+}
+
+// Profile zone each phase is charged to, so the bench and the profiler split a step the same way
+static const ProfileZone phaseZones[SIM_PHASE_COUNT] = {
+    PROFILE_SPAWN, PROFILE_GRID, PROFILE_FIELD, PROFILE_FLOCK, PROFILE_TARGET, PROFILE_INTEGRATE
+};
+
+const char* GetPhaseName(SimulationPhase phase)
+{
+    return GetProfileZoneName(phaseZones[phase]);
+}
+
+// Charges the time since the last mark to a phase and its profile zone, when either is on
+static void MarkPhase(Simulation* sim, SimulationPhase phase, uint64_t* mark)
+{
+    if (sim->timePhases || PROFILE_ENABLED)
+    {
+        uint64_t now = ProfileNow();
+        if (sim->timePhases)
+        {
+            sim->phaseSeconds[phase] += (now - *mark) * 1e-9;
+        }
+#if PROFILE_ENABLED
+        RecordProfileSpan(phaseZones[phase], *mark, now);
+#endif
+        *mark = now;
+    }
+}
+
+// Restarts the worker threads, 0 uses every online core
+void SetSimulationThreads(Simulation* sim, unsigned int threadCount)
+{
+    FreeThreadPool(&sim->pool);
+    InitializeThreadPool(&sim->pool, threadCount);
+}
+
+static void TargetRange(void* context, unsigned int begin, unsigned int end, unsigned int thread)
+{
+    Simulation* sim = (Simulation*)context;
+    (void)thread;
+    for (unsigned int index = begin; index < end; index++)
+    {
+        UpdateBoid(&sim->swarm, index, sim->homeTargets, &sim->grid, &sim->fireField,
+                   &sim->sectionPyramid, sim->maxForceTarget, &sim->claimedCells[index]);
+    }
+}
+
+// Every claim is in by now, so the winner of each cell is settled whatever the thread timing was
+static void ExtinguishRange(void* context, unsigned int begin, unsigned int end, unsigned int thread)
+{
+    Simulation* sim = (Simulation*)context;
+    (void)thread;
+    Grid* grid = &sim->grid;
+    for (unsigned int index = begin; index < end; index++)
+    {
+        int64_t cell = sim->claimedCells[index];
+        if (cell >= 0 && HoldsClaim(grid, cell / grid->cols, cell % grid->cols, index))
+        {
+            ExtinguishCell(grid, cell / grid->cols, cell % grid->cols);
+            sim->swarm.flags[index] |= BOID_HEADING_HOME;
+        }
+    }
+}
+
+static void ReleaseRange(void* context, unsigned int begin, unsigned int end, unsigned int thread)
+{
+    Simulation* sim = (Simulation*)context;
+    (void)thread;
+    Grid* grid = &sim->grid;
+    for (unsigned int index = begin; index < end; index++)
+    {
+        int64_t cell = sim->claimedCells[index];
+        if (cell >= 0)
+        {
+            ReleaseClaim(grid, cell / grid->cols, cell % grid->cols);
+        }
+    }
+}
+
+static void ReserveClaimedCells(Simulation* sim, unsigned int capacity)
+{
+    if (capacity <= sim->claimedCapacity)
+    {
+        return;
+    }
+
+    int64_t* claimedCells = (int64_t*)realloc(sim->claimedCells, capacity * sizeof(int64_t));
+    if (!claimedCells)
+    {
+        fprintf(stderr, "Memory allocation failed for claimed cells\n");
+        exit(1);
+    }
+    sim->claimedCells = claimedCells;
+    sim->claimedCapacity = capacity;
+}
+
+// Batched spawn and despawn, applied once per frame after the update so no loop sees the swarm change
+static void UpdateSwarmSize(Simulation* sim)
+{
+    Swarm* swarm = &sim->swarm;
+
+    RemoveFlaggedBoids(swarm);
+
+    // Add boids if more are needed
+    if (sim->totalBurning * sim->spawnFactor > swarm->count && swarm->count < sim->maxBoids)
+    {
+        for (unsigned int index = 0; index < NUM_HOME_TARGETS; index++)
+        {
+            AddBoid(swarm, sim->homeTargets[index].x, sim->homeTargets[index].y);
+        }
+    }
+
+    // Send a boid home for removal if less are needed
+    if ((swarm->count > sim->totalBurning * sim->spawnFactor) && (swarm->count > sim->minBoids))
+    {
+        float randIndex = GetRandomFloat(RNG_STREAM_SCHEDULE, 0, swarm->count - 1);
+        swarm->flags[(int)randIndex] |= BOID_HEADING_HOME | BOID_TO_BE_REMOVED;
+    }
+}
+
+// What IntegrateSwarm is about to drain: each boid's speed, down to an empty tank
+static void AddEnergySpent(Simulation* sim)
+{
+    const Swarm* swarm = &sim->swarm;
+    double spent = 0;
+    for (unsigned int index = 0; index < swarm->count; index++)
+    {
+        float speed = sqrtf(swarm->velx[index] * swarm->velx[index] + swarm->vely[index] * swarm->vely[index]);
+        spent += fminf(speed, swarm->energy[index]);
+    }
+    sim->energySpent += spent;
+}
+
+static void StepOnce(Simulation* sim)
+{
+    Swarm* swarm = &sim->swarm;
+    PROFILE_BEGIN(PROFILE_STEP);
+    uint64_t mark = (sim->timePhases || PROFILE_ENABLED) ? ProfileNow() : 0;
+
+    // Adjust spreadProbability occasionally
+    if (++sim->iterationCounter >= sim->updateFrequency)
+    {
+        sim->spreadProbability = GetRandomFloat(RNG_STREAM_SCHEDULE, MIN_SPREAD_PROBABILITY, MAX_SPREAD_PROBABILITY);
+        sim->updateFrequency = GetRandomFloat(RNG_STREAM_SCHEDULE, MIN_SPREAD_FREQ_COUNT, MAX_SPREAD_FREQ_COUNT);
+        sim->iterationCounter = 0;
+    }
+    MarkPhase(sim, SIM_PHASE_SPAWN, &mark);
+
+    UpdateGridAndCalculateIntensity(&sim->grid, sim->sectionIntensity, swarm, &sim->totalBurning, sim->spreadProbability);
+    BuildSectionPyramid(&sim->sectionPyramid, sim->sectionIntensity);
+    MarkPhase(sim, SIM_PHASE_GRID, &mark);
+    UpdateFireField(&sim->fireField, &sim->grid, swarm);
+    MarkPhase(sim, SIM_PHASE_FIELD, &mark);
+
+    // Steering runs in phases over the whole swarm so the vector kernels see contiguous batches
+    ApplyEdges(swarm, sim->worldWidth, sim->worldHeight);
+    FlockSwarm(swarm, &sim->hash, &sim->flockSums, &sim->pool);
+    MarkPhase(sim, SIM_PHASE_FLOCK, &mark);
+
+    // Synchronous targeting: every boid reads the grid as the fire step left it and claims cells,
+    // then the lowest boid index claiming each cell puts it out
+    ReserveClaimedCells(sim, swarm->capacity);
+    RunParallel(&sim->pool, swarm->count, BOID_TASK_GRAIN, TargetRange, sim);
+    RunParallel(&sim->pool, swarm->count, BOID_TASK_GRAIN, ExtinguishRange, sim);
+    RunParallel(&sim->pool, swarm->count, BOID_TASK_GRAIN, ReleaseRange, sim);
+    MarkPhase(sim, SIM_PHASE_TARGET, &mark);
+    if (sim->trackEnergy)
+    {
+        AddEnergySpent(sim);
+    }
+    IntegrateSwarm(swarm);
+    MarkPhase(sim, SIM_PHASE_INTEGRATE, &mark);
+
+    UpdateSwarmSize(sim);
+    MarkPhase(sim, SIM_PHASE_SPAWN, &mark);
+
+    sim->frame++;
+    PROFILE_END(PROFILE_STEP);
+    PROFILE_SAMPLE_COUNTERS();
+}
+
+void StepSimulation(Simulation* sim, unsigned int steps)
+{
+    for (unsigned int step = 0; step < steps; step++)
+    {
+        StepOnce(sim);
+    }
+}
+
+// Set the cell under a world position burning, positions off the map are ignored
+void IgniteAtPoint(Simulation* sim, int x, int y)
+{
+    int col = x / CELL_SIZE;
+    int row = y / CELL_SIZE;
+
+    if (x >= 0 && y >= 0 && (unsigned int)row < sim->grid.rows && (unsigned int)col < sim->grid.cols)
+    {
+        IgniteCell(&sim->grid, row, col);
+    }
+}
+
+void GetSimulationStats(const Simulation* sim, SimulationStats* stats)
+{
+    const uint64_t* counts = sim->grid.cellCounts;
+    stats->unburnt = counts[0];
+    stats->burning = counts[1];
+    stats->burnt = counts[2];
+    stats->extinguished = counts[3];
+    stats->liveChunks = sim->grid.liveCount;
+    stats->packedChunks = sim->grid.packedCount;
+    stats->boids = sim->swarm.count;
+    stats->boidsHeadingHome = 0;
+    for (unsigned int index = 0; index < sim->swarm.count; index++)
+    {
+        stats->boidsHeadingHome += (sim->swarm.flags[index] & BOID_HEADING_HOME) != 0;
+    }
+}
+
+void FreeSimulation(Simulation* sim)
+{
+    FreeThreadPool(&sim->pool);
+    free(sim->claimedCells);
+
+    for (unsigned int index = 0; index < sim->numSectionsX; index++)
+    {
+        free(sim->sectionIntensity[index]);
+    }
+    free(sim->sectionIntensity);
+    FreeSectionPyramid(&sim->sectionPyramid);
+
+    FreeSpatialHash(&sim->hash);
+    FreeFlockSums(&sim->flockSums);
+    FreeFireField(&sim->fireField);
+    FreeGrid(&sim->grid);
+    FreeSwarm(&sim->swarm);
+}
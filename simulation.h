@@ -0,0 +1,98 @@
+/******************************************************
+ * File:           simulation.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Headless simulation state and stepping
+ ******************************************************/
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "constants.h"
+#include "boid.h"
+#include "environment.h"
+#include "spatial_hash.h"
+#include "kernels.h"
+#include "threadpool.h"
+#include "section_pyramid.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    SIM_PHASE_SPAWN,      // Spread schedule, adding, marking and removing boids
+    SIM_PHASE_GRID,       // Fire step and section intensities
+    SIM_PHASE_FIELD,      // Nearest-burning-cell field
+    SIM_PHASE_FLOCK,      // Wall forces, spatial hash and flocking
+    SIM_PHASE_TARGET,     // Section choice, closest fire and extinguishing
+    SIM_PHASE_INTEGRATE,  // Positions and energy
+    SIM_PHASE_COUNT
+} SimulationPhase;
+
+// Everything one run owns, stepped without a display by StepSimulation
+typedef struct {
+    Swarm swarm;
+    Grid grid;
+    SpatialHash hash;
+    FlockSums flockSums;
+    FireField fireField;
+    ThreadPool pool;
+    int64_t* claimedCells;           // Per boid, cell claimed this frame or -1
+    unsigned int claimedCapacity;
+    HomeTarget homeTargets[NUM_HOME_TARGETS];
+    float worldWidth;                // Grid extent in pixels
+    float worldHeight;
+    float** sectionIntensity;        // [numSectionsX][numSectionsY]
+    SectionPyramid sectionPyramid;   // Max pyramid over sectionIntensity, rebuilt every step
+    unsigned int numSectionsX;
+    unsigned int numSectionsY;
+    float totalBurning;              // Burning cells counted by the last step
+    float spreadProbability;
+    unsigned int updateFrequency;    // Steps between spread probability changes
+    unsigned int iterationCounter;
+    unsigned int minBoids;           // Swarm size bounds for spawning and removal
+    unsigned int maxBoids;
+    float spawnFactor;               // Boids wanted per burning cell, SPAWN_FACTOR by default
+    float maxForceTarget;            // Steering force towards fires and home, MAX_FORCE_TARGET by default
+    uint64_t seed;
+    unsigned long long frame;        // Steps taken so far
+    bool timePhases;                 // Accumulate phaseSeconds, off by default
+    double phaseSeconds[SIM_PHASE_COUNT];
+    bool trackEnergy;                // Accumulate energySpent, off by default
+    double energySpent;              // Energy drained from boids by flying, refills at home are not subtracted
+} Simulation;
+
+typedef struct {
+    unsigned long long unburnt;
+    unsigned long long burning;
+    unsigned long long burnt;
+    unsigned long long extinguished;
+    unsigned int liveChunks;         // Chunks with full storage
+    unsigned int packedChunks;       // Chunks stored at 2 bits per cell
+    unsigned int boids;
+    unsigned int boidsHeadingHome;
+} SimulationStats;
+
+// The simulation must stay at the same address until FreeSimulation, its thread pool points into it.
+// The world is cols by rows cells, GRID_WIDTH by GRID_HEIGHT fills the screen.
+void InitializeSimulation(Simulation* sim, uint64_t seed, FireEngine engine, unsigned int cols, unsigned int rows);
+// Same with threadCount pool threads from the start instead of NUM_THREADS, 0 uses every online core
+void InitializeSimulationThreads(Simulation* sim, uint64_t seed, FireEngine engine, unsigned int cols, unsigned int rows,
+                                 unsigned int threadCount);
+void SetSimulationThreads(Simulation* sim, unsigned int threadCount);
+void StepSimulation(Simulation* sim, unsigned int steps);
+void IgniteAtPoint(Simulation* sim, int x, int y);
+void GetSimulationStats(const Simulation* sim, SimulationStats* stats);
+void FreeSimulation(Simulation* sim);
+const char* GetPhaseName(SimulationPhase phase);
+
+// Boid steering, boid.c
+#define BOID_TASK_GRAIN 64  // Boids per work item handed to a pool thread
+
+void FlockSwarm(Swarm* swarm, SpatialHash* hash, FlockSums* sums, ThreadPool* pool);
+void UpdateBoid(Swarm* swarm, unsigned int index, const HomeTarget* homeTargets, Grid* grid,
+                const FireField* fireField, const SectionPyramid* sections, float maxForceTarget, int64_t* claimedCell);
+
+#endif
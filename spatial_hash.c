@@ -0,0 +1,151 @@
+/******************************************************
+ * File:           spatial_hash.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Uniform bucket grid for boid neighbor queries
+ ******************************************************/
+
+#include "spatial_hash.h"
+#include "utils.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void InitializeSpatialHash(SpatialHash* hash, float cellSize, float width, float height)
+{
+    // Larger buckets still hold every neighbor, they just hand the flocking pass more candidates
+    if ((width / cellSize) * (height / cellSize) > SPATIAL_HASH_MAX_BUCKETS) {
+        cellSize = ceilf(sqrtf(width * height / SPATIAL_HASH_MAX_BUCKETS));
+    }
+
+    hash->cellSize = cellSize;
+    hash->cols = (unsigned int)ceilf(width / cellSize);
+    hash->rows = (unsigned int)ceilf(height / cellSize);
+    if (hash->cols == 0) hash->cols = 1;
+    if (hash->rows == 0) hash->rows = 1;
+
+    hash->cellStart = (unsigned int*)calloc(hash->cols * hash->rows + 1, sizeof(unsigned int));
+    if (!hash->cellStart) {
+        fprintf(stderr, "Memory allocation failed for spatial hash buckets\n");
+        exit(1);
+    }
+
+    hash->indices = NULL;
+    hash->boidSlot = NULL;
+    hash->boidCell = NULL;
+    hash->posx = NULL;
+    hash->posy = NULL;
+    hash->velx = NULL;
+    hash->vely = NULL;
+    hash->capacity = 0;
+}
+
+void GetSpatialHashCell(const SpatialHash* hash, float x, float y, unsigned int* cellX, unsigned int* cellY)
+{
+    // Boids can drift past the screen edge, clamp them into the border buckets
+    int col = (int)floorf(x / hash->cellSize);
+    int row = (int)floorf(y / hash->cellSize);
+
+    if (col < 0) col = 0;
+    if (col >= (int)hash->cols) col = hash->cols - 1;
+    if (row < 0) row = 0;
+    if (row >= (int)hash->rows) row = hash->rows - 1;
+
+    *cellX = (unsigned int)col;
+    *cellY = (unsigned int)row;
+}
+
+static void ReserveSpatialHash(SpatialHash* hash, unsigned int numBoids)
+{
+    if (numBoids <= hash->capacity) {
+        return;
+    }
+
+    unsigned int newCapacity = hash->capacity ? hash->capacity : 64;
+    while (newCapacity < numBoids) {
+        newCapacity *= 2;
+    }
+
+    free(hash->indices);
+    free(hash->boidSlot);
+    free(hash->boidCell);
+    free(hash->posx);
+    free(hash->posy);
+    free(hash->velx);
+    free(hash->vely);
+
+    // Rebuilt from scratch every frame, so nothing needs to survive the resize
+    hash->indices = (unsigned int*)malloc(newCapacity * sizeof(unsigned int));
+    hash->boidSlot = (unsigned int*)malloc(newCapacity * sizeof(unsigned int));
+    hash->boidCell = (unsigned int*)malloc(newCapacity * sizeof(unsigned int));
+    if (!hash->indices || !hash->boidSlot || !hash->boidCell) {
+        fprintf(stderr, "Memory allocation failed for spatial hash entries\n");
+        exit(1);
+    }
+    hash->posx = (float*)AllocateAligned(newCapacity + BOID_BATCH, sizeof(float));
+    hash->posy = (float*)AllocateAligned(newCapacity + BOID_BATCH, sizeof(float));
+    hash->velx = (float*)AllocateAligned(newCapacity + BOID_BATCH, sizeof(float));
+    hash->vely = (float*)AllocateAligned(newCapacity + BOID_BATCH, sizeof(float));
+    hash->capacity = newCapacity;
+}
+
+void BuildSpatialHash(SpatialHash* hash, const Swarm* swarm)
+{
+    unsigned int numCells = hash->cols * hash->rows;
+    unsigned int numBoids = swarm->count;
+
+    ReserveSpatialHash(hash, numBoids);
+
+    // Counting sort of boid indices by bucket, stable so each bucket lists boids in array order
+    memset(hash->cellStart, 0, (numCells + 1) * sizeof(unsigned int));
+    for (unsigned int index = 0; index < numBoids; ++index) {
+        unsigned int cellX, cellY;
+        GetSpatialHashCell(hash, swarm->posx[index], swarm->posy[index], &cellX, &cellY);
+        hash->boidCell[index] = cellY * hash->cols + cellX;
+        hash->cellStart[hash->boidCell[index] + 1]++;
+    }
+
+    for (unsigned int cell = 0; cell < numCells; ++cell) {
+        hash->cellStart[cell + 1] += hash->cellStart[cell];
+    }
+
+    // Use the end offsets as write cursors, then shift them back into place
+    for (unsigned int index = 0; index < numBoids; ++index) {
+        unsigned int slot = hash->cellStart[hash->boidCell[index]]++;
+        hash->indices[slot] = index;
+        hash->boidSlot[index] = slot;
+        hash->posx[slot] = swarm->posx[index];
+        hash->posy[slot] = swarm->posy[index];
+        hash->velx[slot] = swarm->velx[index];
+        hash->vely[slot] = swarm->vely[index];
+    }
+    for (unsigned int cell = numCells; cell > 0; --cell) {
+        hash->cellStart[cell] = hash->cellStart[cell - 1];
+    }
+    hash->cellStart[0] = 0;
+}
+
+void FreeSpatialHash(SpatialHash* hash)
+{
+    free(hash->cellStart);
+    free(hash->indices);
+    free(hash->boidSlot);
+    free(hash->boidCell);
+    free(hash->posx);
+    free(hash->posy);
+    free(hash->velx);
+    free(hash->vely);
+    hash->cellStart = NULL;
+    hash->indices = NULL;
+    hash->boidSlot = NULL;
+    hash->boidCell = NULL;
+    hash->posx = NULL;
+    hash->posy = NULL;
+    hash->velx = NULL;
+    hash->vely = NULL;
+    hash->capacity = 0;
+}
@@ -0,0 +1,38 @@
+/******************************************************
+ * File:           spatial_hash.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Uniform bucket grid for boid neighbor queries
+ ******************************************************/
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "boid.h"
+
+#define SPATIAL_HASH_MAX_BUCKETS (1u << 18)  // Buckets grow past cellSize on worlds too large for this many
+
+typedef struct {
+    float cellSize;
+    unsigned int cols;
+    unsigned int rows;
+    unsigned int* cellStart;  // cols * rows + 1 offsets into indices, one range per bucket
+    unsigned int* indices;    // Boid indices ordered by bucket
+    unsigned int* boidSlot;   // Position of each boid in the bucket order, inverse of indices
+    unsigned int* boidCell;   // Bucket of each boid, scratch for the counting sort
+    float* posx;              // Swarm snapshot in bucket order, so a bucket row is one contiguous run
+    float* posy;
+    float* velx;
+    float* vely;
+    unsigned int capacity;    // Boids the arrays can hold, snapshot arrays are padded by BOID_BATCH past it
+} SpatialHash;
+
+void InitializeSpatialHash(SpatialHash* hash, float cellSize, float width, float height);
+void BuildSpatialHash(SpatialHash* hash, const Swarm* swarm);
+void GetSpatialHashCell(const SpatialHash* hash, float x, float y, unsigned int* cellX, unsigned int* cellY);
+void FreeSpatialHash(SpatialHash* hash);
+
+#endif // SPATIAL_HASH_H
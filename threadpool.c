@@ -0,0 +1,208 @@
+/******************************************************
+ * File:           threadpool.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Worker threads for data-parallel loops with range stealing
+ ******************************************************/
+
+#include "threadpool.h"
+#include "rng.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static uint64_t PackRange(unsigned int next, unsigned int end)
+{
+    return ((uint64_t)end << 32) | next;
+}
+
+// Takes up to grain items from the front of a thread's own range
+static bool PopOwnRange(WorkRange* own, unsigned int grain, unsigned int* begin, unsigned int* end)
+{
+    uint64_t range = __atomic_load_n(&own->range, __ATOMIC_ACQUIRE);
+    for (;;)
+    {
+        unsigned int next = (unsigned int)range;
+        unsigned int last = (unsigned int)(range >> 32);
+        if (next >= last)
+        {
+            return false;
+        }
+
+        unsigned int take = (last - next < grain) ? last - next : grain;
+        if (__atomic_compare_exchange_n(&own->range, &range, PackRange(next + take, last), false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            *begin = next;
+            *end = next + take;
+            return true;
+        }
+    }
+}
+
+// Moves the back half of the first non-empty victim range into the thief's own range
+static bool StealRange(ThreadPool* pool, unsigned int thief)
+{
+    for (unsigned int offset = 1; offset < pool->threadCount; offset++)
+    {
+        WorkRange* victim = &pool->ranges[(thief + offset) % pool->threadCount];
+        uint64_t range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+        for (;;)
+        {
+            unsigned int next = (unsigned int)range;
+            unsigned int last = (unsigned int)(range >> 32);
+            if (next >= last)
+            {
+                break;
+            }
+
+            unsigned int half = (last - next + 1) / 2;
+            if (__atomic_compare_exchange_n(&victim->range, &range, PackRange(next, last - half), false,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            {
+                __atomic_store_n(&pool->ranges[thief].range, PackRange(last - half, last), __ATOMIC_RELEASE);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void RunRanges(ThreadPool* pool, unsigned int thread)
+{
+    unsigned int begin, end;
+    do
+    {
+        while (PopOwnRange(&pool->ranges[thread], pool->grain, &begin, &end))
+        {
+            pool->task(pool->context, begin, end, thread);
+        }
+    } while (StealRange(pool, thread));
+}
+
+static void* WorkerMain(void* argument)
+{
+    PoolWorker* worker = (PoolWorker*)argument;
+    ThreadPool* pool = worker->pool;
+    unsigned int thread = worker->index;
+    unsigned int seen = 0;
+
+    SetRngThread(thread);
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->stopping)
+        {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stopping)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        RunRanges(pool, thread);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0)
+        {
+            pthread_cond_signal(&pool->done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// A threadCount of 0 uses every online core
+void InitializeThreadPool(ThreadPool* pool, unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threadCount = (cores > 0) ? (unsigned int)cores : 1;
+    }
+    if (threadCount > THREAD_POOL_MAX_THREADS)
+    {
+        threadCount = THREAD_POOL_MAX_THREADS;
+    }
+
+    *pool = (ThreadPool){0};
+    pool->threadCount = threadCount;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (unsigned int thread = 1; thread < threadCount; thread++)
+    {
+        pool->workers[thread].pool = pool;
+        pool->workers[thread].index = thread;
+        if (pthread_create(&pool->workers[thread].handle, NULL, WorkerMain, &pool->workers[thread]) != 0)
+        {
+            fprintf(stderr, "Thread creation failed for thread pool\n");
+            exit(1);
+        }
+    }
+}
+
+// Splits [0, count) evenly over the threads, threads that run dry steal from the others.
+// Returns once every item has run; the calling thread works too. A NULL pool runs the loop inline.
+void RunParallel(ThreadPool* pool, unsigned int count, unsigned int grain, ParallelTask task, void* context)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (pool == NULL || pool->threadCount <= 1 || count <= grain)
+    {
+        task(context, 0, count, 0);
+        return;
+    }
+
+    unsigned int threadCount = pool->threadCount;
+    for (unsigned int thread = 0; thread < threadCount; thread++)
+    {
+        unsigned int begin = (unsigned int)((uint64_t)count * thread / threadCount);
+        unsigned int end = (unsigned int)((uint64_t)count * (thread + 1) / threadCount);
+        __atomic_store_n(&pool->ranges[thread].range, PackRange(begin, end), __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->context = context;
+    pool->grain = grain ? grain : 1;
+    pool->busy = threadCount - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    RunRanges(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0)
+    {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void FreeThreadPool(ThreadPool* pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (unsigned int thread = 1; thread < pool->threadCount; thread++)
+    {
+        pthread_join(pool->workers[thread].handle, NULL);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+}
@@ -0,0 +1,57 @@
+/******************************************************
+ * File:           threadpool.h
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Worker threads for data-parallel loops with range stealing
+ ******************************************************/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define THREAD_POOL_MAX_THREADS 256
+
+// Runs items [begin, end) of the loop on worker thread, 0 is the calling thread
+typedef void (*ParallelTask)(void* context, unsigned int begin, unsigned int end, unsigned int thread);
+
+// Remaining items of one thread, next in the low half and end in the high half, so both move in one CAS
+typedef struct {
+    uint64_t range;
+    char padding[64 - sizeof(uint64_t)];  // One cache line per thread
+} WorkRange;
+
+struct ThreadPool;
+
+typedef struct {
+    struct ThreadPool* pool;
+    pthread_t handle;
+    unsigned int index;
+} PoolWorker;
+
+typedef struct ThreadPool {
+    PoolWorker workers[THREAD_POOL_MAX_THREADS];  // Slot 0 is the calling thread and has no handle
+    WorkRange ranges[THREAD_POOL_MAX_THREADS];
+    unsigned int threadCount;            // Including the calling thread
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned int generation;             // Bumped for every loop, workers wait for a change
+    unsigned int busy;                   // Workers still inside the current loop
+    bool stopping;
+    ParallelTask task;
+    void* context;
+    unsigned int grain;                  // Items claimed per pop from a thread's own range
+} ThreadPool;
+
+// The pool must stay at the same address until FreeThreadPool, workers keep a pointer to it
+void InitializeThreadPool(ThreadPool* pool, unsigned int threadCount);
+void RunParallel(ThreadPool* pool, unsigned int count, unsigned int grain, ParallelTask task, void* context);
+void FreeThreadPool(ThreadPool* pool);
+
+#endif
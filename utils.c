@@ -3,22 +3,24 @@
  * Project:        Boid Swarm Firefight
  * Author:         Peter Ryseck
  * Date Created:   February 8, 2025
- * Last Updated:   February 8, 2025
+ * Last Updated:   October 16, 2026
  *
  * Description:    General utility functions
  ******************************************************/
 
 #include "boid.h"
+#include "utils.h"
 #include "constants.h"
 #include <stdio.h>
 #include "stdlib.h"
+#include <string.h>
 #include <time.h>
 #include <math.h>
 
-float GetRandomFloat(float min, float max)
+float GetRandomFloat(RngSubsystem subsystem, float min, float max)
 {
-    // Generate a random float between 0.0 and 1.0
-    float random = (float)rand() / (float)RAND_MAX;
+    // Generate a random float between 0.0 and 1.0 from the calling thread's stream
+    float random = RngUniform(GetRngStream(subsystem));
 
     // Scale and shift the value to the desired range
     return min + random * (max - min);
@@ -29,11 +31,6 @@ float EuclideanDistance(float x1, float y1, float x2, float y2)
     return sqrtf((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
 }
 
-float Distance(Boid* boid1, Boid* boid2)
-{
-    return EuclideanDistance(boid1->posx, boid1->posy, boid2->posx, boid2->posy);
-}
-
 void Magnitude(float vx, float vy, float *mag)
 {
     *mag = EuclideanDistance(0.0f, 0.0f, vx, vy);
@@ -64,3 +61,31 @@ void Normalize(float *vx, float *vy)
         *vy /= len;
     }
 }
+
+// Zeroed allocation aligned to BOID_ALIGNMENT for the vector kernels
+void* AllocateAligned(size_t count, size_t size)
+{
+    size_t bytes = count * size;
+    bytes = (bytes + BOID_ALIGNMENT - 1) / BOID_ALIGNMENT * BOID_ALIGNMENT;
+    if (bytes == 0)
+    {
+        bytes = BOID_ALIGNMENT;
+    }
+
+    void* memory = aligned_alloc(BOID_ALIGNMENT, bytes);
+    if (memory == NULL)
+    {
+        fprintf(stderr, "Memory allocation failed for aligned buffer\n");
+        exit(1);
+    }
+    memset(memory, 0, bytes);
+    return memory;
+}
+
+// Monotonic wall clock for timing, unrelated to the frame clock of the viewer
+double GetTimeSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
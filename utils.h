@@ -3,7 +3,7 @@
  * Project:        Boid Swarm Firefight
  * Author:         Peter Ryseck
  * Date Created:   February 8, 2025
- * Last Updated:   February 8, 2025
+ * Last Updated:   October 16, 2026
  *
  * Description:    General utility functions
  ******************************************************/
@@ -11,11 +11,15 @@
 #ifndef UTILS_H
 #define UTILS_H
 
-float GetRandomFloat(float min, float max);
-float Distance(Boid* boid1, Boid* boid2);
-float LimitVector(float *vx, float *vy, float min, float max);
-float Magnitude(float vx, float vy, float *mag);
-float Normalize(float *vx, float *vy);
+#include "rng.h"
+#include <stddef.h>
+
+float GetRandomFloat(RngSubsystem subsystem, float min, float max);
+void LimitVector(float *vx, float *vy, float min, float max);
+void Magnitude(float vx, float vy, float *mag);
+void Normalize(float *vx, float *vy);
 float EuclideanDistance(float x1, float y1, float x2, float y2);
+void* AllocateAligned(size_t count, size_t size);
+double GetTimeSeconds(void);
 
 #endif
@@ -0,0 +1,329 @@
+/******************************************************
+ * File:           viewer.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    SDL viewer, a thin client of the simulation core
+ * Compile: gcc -O3 -march=native -o boid viewer.c display.c simulation.c boid.c utils.c environment.c bitfire.c spatial_hash.c kernels.c rng.c threadpool.c section_pyramid.c chunks.c checkpoint.c recorder.c replay.c sim_thread.c publisher.c profile.c -I/opt/homebrew/include/SDL2 -L/opt/homebrew/lib -L/opt/homebrew/opt/openblas/lib -I/opt/homebrew/opt/openblas/include -lopenblas -lSDL2 -lpthread -lz
+ *          add -DBOID_PROFILE for the F3 profile overlay and --trace
+ * Usage:   ./boid [--record file] [--trace file] [--publish name] [seed]
+ *          ./boid --replay file
+ ******************************************************/
+
+#include "simulation.h"
+#include "display.h"
+#include "recorder.h"
+#include "replay.h"
+#include "sim_thread.h"
+#include "profile.h"
+#include "utils.h"
+#include "constants.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define REPLAY_MAX_SPEED 1024.0  // Recorded frames per displayed frame
+#define REPLAY_MIN_SPEED (1.0 / 16)
+
+// Plays a recording back without stepping anything. Space pauses, left and right pick the direction (or
+// step one frame while paused), up and down double and halve the speed, home and end jump to either end,
+// and holding the left button scrubs across the recording with the mouse.
+static int RunReplay(const char* path)
+{
+    Replay replay;
+    if (!OpenReplay(&replay, path))
+    {
+        return 1;
+    }
+    if (replay.grid.cols > GRID_WIDTH || replay.grid.rows > GRID_HEIGHT)
+    {
+        fprintf(stderr, "Recording %s is %ux%u cells, the window shows up to %ux%u\n", path,
+                replay.grid.cols, replay.grid.rows, GRID_WIDTH, GRID_HEIGHT);
+        CloseReplay(&replay);
+        return 1;
+    }
+    printf("Replaying %llu frames, seed %llu\n", replay.frameCount, (unsigned long long)replay.header->seed);
+
+    SDL_Window *window = NULL;
+    SDL_Renderer *renderer = NULL;
+    InitDisplay(&window, &renderer);
+    SDL_Texture *gridTexture = CreateGridTexture(renderer, &replay.grid);
+    SDL_Texture *homeSprite = CreateHomeTargetSprite(renderer);
+    BoidMesh boidMesh = {0};
+    ThreadPool pool;
+    InitializeThreadPool(&pool, NUM_THREADS);
+
+    SDL_Event event;
+    bool isRunning = SeekReplay(&replay, 0);
+    bool mouseHeld = false;
+    bool paused = false;
+    double position = 0;   // Index entry, fractional below one frame per displayed frame
+    double speed = 1;      // Negative plays backward
+    double lastEntry = (double)(replay.frameCount - 1);
+
+    while (isRunning)
+    {
+        Uint32 startTime = SDL_GetTicks();
+
+        while (SDL_PollEvent(&event))
+        {
+            if (event.type == SDL_QUIT)
+            {
+                isRunning = false;
+            }
+            else if (event.type == SDL_MOUSEBUTTONDOWN || event.type == SDL_MOUSEBUTTONUP)
+            {
+                if (event.button.button == SDL_BUTTON_LEFT)
+                {
+                    mouseHeld = (event.type == SDL_MOUSEBUTTONDOWN);
+                }
+            }
+            else if (event.type == SDL_KEYDOWN)
+            {
+                int key = event.key.keysym.sym;
+                if (key == SDLK_SPACE)
+                {
+                    paused = !paused;
+                }
+                else if (key == SDLK_LEFT || key == SDLK_RIGHT)
+                {
+                    double direction = (key == SDLK_RIGHT) ? 1 : -1;
+                    speed = direction * fabs(speed);
+                    if (paused)
+                    {
+                        position = floor(position) + direction;
+                    }
+                }
+                else if (key == SDLK_UP && fabs(speed) < REPLAY_MAX_SPEED)
+                {
+                    speed *= 2;
+                }
+                else if (key == SDLK_DOWN && fabs(speed) > REPLAY_MIN_SPEED)
+                {
+                    speed /= 2;
+                }
+                else if (key == SDLK_HOME)
+                {
+                    position = 0;
+                }
+                else if (key == SDLK_END)
+                {
+                    position = lastEntry;
+                }
+            }
+        }
+
+        if (mouseHeld)
+        {
+            int mouseX, mouseY;
+            SDL_GetMouseState(&mouseX, &mouseY);
+            position = lastEntry * mouseX / (SCREEN_WIDTH - 1);
+        }
+        else if (!paused)
+        {
+            position += speed;
+        }
+        position = position < 0 ? 0 : (position > lastEntry ? lastEntry : position);
+
+        if (!SeekReplay(&replay, (unsigned long long)position))
+        {
+            break;
+        }
+
+        char title[96];
+        snprintf(title, sizeof(title), "Replay frame %llu of %llu, %gx%s",
+                 (unsigned long long)replay.index[replay.entry].frame,
+                 (unsigned long long)replay.index[replay.frameCount - 1].frame, speed, paused ? ", paused" : "");
+        SDL_SetWindowTitle(window, title);
+
+        RenderGrid(renderer, gridTexture, &replay.grid);
+        RenderHomeTargets(renderer, homeSprite, replay.homeTargets, NUM_HOME_TARGETS);
+        RenderBoids(renderer, &boidMesh, &replay.swarm, &pool);
+        PresentFrame(renderer);
+
+        Uint32 frameTime = SDL_GetTicks() - startTime;
+        if (frameTime < CAP_FRAME_TIME)
+        {
+            SDL_Delay(CAP_FRAME_TIME - frameTime);
+        }
+    }
+
+    FreeThreadPool(&pool);
+    FreeBoidMesh(&boidMesh);
+    SDL_DestroyTexture(homeSprite);
+    SDL_DestroyTexture(gridTexture);
+    CleanupDisplay(window, renderer);
+    CloseReplay(&replay);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0)
+    {
+        return RunReplay(argv[2]);
+    }
+
+    const char* recordPath = NULL;
+    const char* tracePath = NULL;
+    const char* publishName = NULL;
+    while (argc > 2 && (strcmp(argv[1], "--record") == 0 || strcmp(argv[1], "--trace") == 0 ||
+                        strcmp(argv[1], "--publish") == 0))
+    {
+        if (strcmp(argv[1], "--record") == 0)
+        {
+            recordPath = argv[2];
+        }
+        else if (strcmp(argv[1], "--trace") == 0)
+        {
+            tracePath = argv[2];
+        }
+        else
+        {
+            publishName = argv[2];
+        }
+        argc -= 2;
+        argv += 2;
+    }
+    if (tracePath && !PROFILE_ENABLED)
+    {
+        fprintf(stderr, "--trace needs a build with -DBOID_PROFILE\n");
+        return 1;
+    }
+
+    // Seed from the command line to replay a run, otherwise from the clock
+    uint64_t seed = (argc > 1) ? strtoull(argv[1], NULL, 0) : (uint64_t)time(NULL);
+    printf("Random seed: %llu\n", (unsigned long long)seed);
+
+    Simulation sim;
+    InitializeSimulation(&sim, seed, FIRE_ENGINE, GRID_WIDTH, GRID_HEIGHT);
+
+    Recorder recorder;
+    if (recordPath)
+    {
+        if (!OpenRecorder(&recorder, &sim, recordPath))
+        {
+            FreeSimulation(&sim);
+            return 1;
+        }
+        RecordFrame(&recorder, &sim);  // Starting state
+    }
+
+    Publisher publisher;
+    if (publishName)
+    {
+        if (!OpenPublisher(&publisher, &sim, publishName))
+        {
+            if (recordPath)
+            {
+                CloseRecorder(&recorder);
+            }
+            FreeSimulation(&sim);
+            return 1;
+        }
+        PublishFrame(&publisher, &sim);
+    }
+
+    // From here on the simulation belongs to its thread, this one only draws its snapshots
+    Grid view;
+    InitializeViewGrid(&view, sim.grid.cols, sim.grid.rows);
+    uint64_t viewStep = 0;
+    if (tracePath)
+    {
+        StartProfileTrace();
+    }
+    SimThread simThread;
+    StartSimThread(&simThread, &sim, recordPath ? &recorder : NULL, publishName ? &publisher : NULL, SIM_STEP_RATE);
+
+    SDL_Window *window = NULL;
+    SDL_Renderer *renderer = NULL;
+    InitDisplay(&window, &renderer);
+    SDL_Texture *gridTexture = CreateGridTexture(renderer, &view);
+    SDL_Texture *homeSprite = CreateHomeTargetSprite(renderer);
+    BoidMesh boidMesh = {0};
+    Swarm drawn = {0};
+    ThreadPool renderPool;  // The simulation's pool is busy with its steps
+    InitializeThreadPool(&renderPool, NUM_THREADS);
+
+    SDL_Event event;
+    bool isRunning = true;
+    bool mouseHeld = false;
+    bool showProfile = false;
+    Uint32 lastFireSpawnTime = 0; // Track last fire spawn time
+
+    // Paced by vsync in SDL_RenderPresent, the simulation keeps its own clock
+    while (isRunning)
+    {
+        while (SDL_PollEvent(&event))
+        {
+            if (event.type == SDL_QUIT)
+            {
+                isRunning = false;
+            }
+            else if (event.type == SDL_MOUSEBUTTONDOWN)
+            {
+                if (event.button.button == SDL_BUTTON_LEFT)
+                {
+                    mouseHeld = true;  // Mouse is held down
+                }
+            }
+            else if (event.type == SDL_MOUSEBUTTONUP)
+            {
+                if (event.button.button == SDL_BUTTON_LEFT)
+                {
+                    mouseHeld = false;  // Mouse is released
+                }
+            }
+            else if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3)
+            {
+                showProfile = !showProfile;
+            }
+        }
+
+        // Limit fire spawn rate to every 30ms
+        if (mouseHeld && SDL_GetTicks() - lastFireSpawnTime > 30)
+        {
+            int mouseX, mouseY;
+            SDL_GetMouseState(&mouseX, &mouseY);
+            PushSimCommand(&simThread, (SimCommand){SIM_COMMAND_IGNITE, mouseX, mouseY});  // Set to burning
+
+            lastFireSpawnTime = SDL_GetTicks(); // Update last spawn time
+        }
+
+        const SimSnapshot *snapshot = AcquireSnapshot(&simThread);
+        UpdateViewGrid(snapshot, &view, &viewStep);
+        InterpolateSnapshot(&simThread, snapshot, GetTimeSeconds(), &drawn);
+
+        RenderGrid(renderer, gridTexture, &view);
+        RenderHomeTargets(renderer, homeSprite, sim.homeTargets, NUM_HOME_TARGETS);
+        RenderBoids(renderer, &boidMesh, &drawn, &renderPool);
+        if (showProfile)
+        {
+            RenderProfileOverlay(renderer);
+        }
+        PresentFrame(renderer);
+    }
+
+    StopSimThread(&simThread);
+    if (publishName)
+    {
+        ClosePublisher(&publisher);
+    }
+    FreeThreadPool(&renderPool);
+    FreeSwarm(&drawn);
+    FreeBoidMesh(&boidMesh);
+    SDL_DestroyTexture(homeSprite);
+    SDL_DestroyTexture(gridTexture);
+    CleanupDisplay(window, renderer);
+    FreeViewGrid(&view);
+    bool recorded = !recordPath || CloseRecorder(&recorder);
+    bool traced = !tracePath || WriteProfileTrace(tracePath);
+    FreeSimulation(&sim);
+
+    return (recorded && traced) ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+/******************************************************
+ * File:           watch.c
+ * Project:        Boid Swarm Firefight
+ * Author:         Peter Ryseck
+ * Date Created:   October 16, 2026
+ * Last Updated:   October 16, 2026
+ *
+ * Description:    Follows a published simulation from another process and prints a status line a second
+ * Compile: gcc -O3 -march=native -o boid-watch watch.c publisher.c utils.c rng.c -lm
+ * Usage:   ./boid-watch [name]   (name as given to --publish, /boid by default)
+ ******************************************************/
+
+#include "publisher.h"
+#include "utils.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define WATCH_INTERVAL 1.0  // Seconds between status lines
+
+int main(int argc, char* argv[])
+{
+    const char* name = (argc > 1) ? argv[1] : "/boid";
+    PublishReader reader;
+    if (!OpenPublishReader(&reader, name))
+    {
+        return 1;
+    }
+
+    const PublishHeader* header = reader.header;
+    printf("watching %s: pid %u, seed %llu, world %ux%u, %u boid slots%s\n", name, header->writerPid,
+           (unsigned long long)header->seed, header->cols, header->rows, header->boidCapacity,
+           header->blockOffsets[PUBLISH_CELLS] ? "" : ", no cells");
+
+    uint64_t lastFrame = 0;
+    double lastTime = GetTimeSeconds();
+    unsigned long long retries = 0;
+    for (;;)
+    {
+        struct timespec pause = {(time_t)WATCH_INTERVAL, (long)((WATCH_INTERVAL - (time_t)WATCH_INTERVAL) * 1e9)};
+        nanosleep(&pause, NULL);
+        bool closed = __atomic_load_n(&header->closed, __ATOMIC_ACQUIRE);
+
+        // Everything is read straight from the slot, then thrown away if the writer got into it meanwhile
+        uint64_t sequence;
+        const PublishSlot* slot;
+        uint64_t frame, cellCounts[CELL_STATE_COUNT];
+        unsigned int boids, headingHome;
+        float hottestSection, meanEnergy;
+        for (;;)
+        {
+            slot = BeginPublishRead(&reader, &sequence);
+            if (!slot)
+            {
+                break;
+            }
+            frame = slot->frame;
+            boids = slot->boidCount;
+            memcpy(cellCounts, slot->cellCounts, sizeof(cellCounts));
+
+            const float* energy = (const float*)GetPublishBlock(&reader, slot, PUBLISH_ENERGY);
+            const unsigned char* flags = (const unsigned char*)GetPublishBlock(&reader, slot, PUBLISH_FLAGS);
+            double energySum = 0;
+            headingHome = 0;
+            for (unsigned int boid = 0; boid < boids && boid < header->boidCapacity; boid++)
+            {
+                energySum += energy[boid];
+                headingHome += (flags[boid] & BOID_HEADING_HOME) != 0;
+            }
+            meanEnergy = boids ? (float)(energySum / boids) : 0.0f;
+
+            const float* sections = (const float*)GetPublishBlock(&reader, slot, PUBLISH_SECTIONS);
+            hottestSection = 0;
+            for (unsigned int section = 0; section < header->numSectionsX * header->numSectionsY; section++)
+            {
+                if (sections[section] > hottestSection) hottestSection = sections[section];
+            }
+
+            if (EndPublishRead(slot, sequence))
+            {
+                break;
+            }
+            retries++;
+        }
+
+        if (slot)
+        {
+            double now = GetTimeSeconds();
+            printf("frame %llu (%.0f steps/s): burning %llu, burnt %llu, extinguished %llu, boids %u (%u heading home, "
+                   "mean energy %.1f), hottest section %.1f, retries %llu\n",
+                   (unsigned long long)frame, (frame - lastFrame) / (now - lastTime),
+                   (unsigned long long)cellCounts[1], (unsigned long long)cellCounts[2],
+                   (unsigned long long)cellCounts[3], boids, headingHome, meanEnergy, hottestSection, retries);
+            fflush(stdout);
+            lastFrame = frame;
+            lastTime = now;
+        }
+        if (closed)
+        {
+            break;
+        }
+    }
+
+    ClosePublishReader(&reader);
+    return 0;
+}